@@ -344,17 +344,20 @@ class GUI:
         
         self.cell_id_existed_on_grid.clear()
 
-        # 画细胞
-        for cell in self.env.get_cells():
+        # 画细胞：一次取回结构化数组，按列转成 Python 数值
+        cells = self.env.get_cells_array()
+        if len(cells) == 0:
+            return
+        for cell_id, x, y in zip(cells["id"].tolist(), cells["x"].tolist(), cells["y"].tolist()):
             dpg.draw_rectangle(
-                [cell["x"] * self.cell_size, cell["y"] * self.cell_size],
-                [(cell['x'] + 1) * self.cell_size, (cell['y'] + 1) * self.cell_size],
+                [x * self.cell_size, y * self.cell_size],
+                [(x + 1) * self.cell_size, (y + 1) * self.cell_size],
                 color=cell_color,
                 fill=cell_color,
                 parent="grid_drawlist",
-                tag=f"C{cell['id']}"
+                tag=f"C{cell_id}"
             )
-            self.cell_id_existed_on_grid.add(f"C{cell['id']}")
+            self.cell_id_existed_on_grid.add(f"C{cell_id}")
 
     # State Toggler
     def toggle_grid_line(self, sender, app_data):
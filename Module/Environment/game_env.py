@@ -5,12 +5,14 @@ import smart_life_core
 from ..Configs.config import Config
 
 class SmartGameEnv:
-    def __init__(self, width=50, height=50, config_file=".\\config.txt"):
+    def __init__(self, width=50, height=50, config_file=".\\config.txt", num_threads=0, seed=None):
         # 确保配置文件存在
         if not os.path.exists(config_file):
             self._create_default_config(config_file)
             
-        self.env = smart_life_core.GameEnvironment(width, height, config_file)
+        # num_threads 为 0 时由 C++ 端读取配置项 THREADS；seed 为 None 时由 C++ 端随机取种子
+        self.env = smart_life_core.GameEnvironment(width, height, config_file, num_threads,
+                                                   -1 if seed is None else int(seed))
         self.width = width
         self.height = height
         self.configs = Config()
@@ -51,6 +53,22 @@ RESTORE_VALUE = 0.2
 # Grid size
 ENV_WIDTH = 100
 ENV_HEIGHT = 100
+
+# Worker threads used by update() (1 = serial)
+THREADS = 1
+
+# Node cache limit of the HashLife engine used by advance(). Garbage collection only runs
+# between power-of-two jumps, so one large jump may temporarily exceed this limit
+HASHLIFE_MAX_NODES = 2000000
+
+# Rule string in B/S notation, overrides LIVE_*/BREED_* when set (e.g. B36/S23)
+# RULE = B3/S23
+
+# Stepping engine: simd (default, picked from CPUID) or lut (4x4 block lookup table)
+# KERNEL = simd
+
+# Board boundary: dead (cells beyond the edge are empty) or wrap (toroidal)
+# BOUNDARY = dead
 """
         with open(config_file, 'w') as f:
             f.write(default_config)
@@ -78,23 +96,37 @@ ENV_HEIGHT = 100
         obs = self.get_observation()
         reward = self.__calculate_reward(step)
         done = self.__is_done()
+        stats = self.env.get_step_stats()
         info = {
             'population': self.env.get_population(),
-            'density': self.env.get_density()
+            'density': self.env.get_density(),
+            'births': stats['births'],
+            'deaths': stats['deaths'],
+            'moves': stats['moves']
         }
         
         return obs, reward, done, info
     
-    def get_observation(self):
+    def get_observation(self, out=None):
         """
         获取每一个细胞周围的邻居状态
+        传入预分配的 (容量, 观测长度) float32 数组时直接写入该数组，返回已填充的前 n 行
         """
         try:
+            if out is not None:
+                return self.env.get_cell_states_into(out)
             return self.env.get_cell_states()
         except Exception as e:
             print(f"Error getting cell states: {e}")
             return np.array([])
     
+    def get_packed_observation(self):
+        """
+        获取按位压缩的邻居状态（每个细胞 (观测长度 + 7) // 8 字节），适合存入经验回放
+        用 smart_life_core.unpack_cell_states(packed, obs_size) 还原为 float32
+        """
+        return self.env.get_cell_states_packed()
+
     def __calculate_reward(self, step):
         """
         计算奖励
@@ -130,6 +162,26 @@ ENV_HEIGHT = 100
     
     def get_population(self):
         return self.env.get_population()
+
+    def advance(self, generations):
+        """
+        连续推进若干代（不带移动），纯规则模式下推进较多代数时由 C++ 端使用 HashLife 引擎，局面混沌时仍逐代演化
+        """
+        self.env.advance(int(generations))
+
+    def run(self, generations, stop_when_done=True, new_density=False):
+        """
+        在 C++ 端连续演化至多 generations 代（不带移动），结束条件与 step() 的 done 相同
+        返回形状为 (实际代数, 5) 的数组，各列依次为 population、density、new_density、births、deaths
+        """
+        saturation = 0.8 if stop_when_done else 0.0
+        return self.env.run(int(generations), stop_when_done, saturation, new_density)
+
+    def get_kernel_name(self):
+        """
+        获取 C++ 内核正在使用的演化核心（scalar/sse2/avx2/avx512）
+        """
+        return self.env.get_kernel_name()
     
     def set_cell(self, x, y):
         self.env.set_cell(int(x), int(y))
@@ -140,16 +192,51 @@ ENV_HEIGHT = 100
     def get_density(self):
         return self.env.get_density()
     
-    def get_grid_state(self):
+    def seed(self, seed):
+        """
+        重新播种，之后的 reset/step 可完整复现
+        """
+        self.env.seed(int(seed))
+
+    def save_snapshot(self, path):
+        """
+        把环境完整状态（网格、细胞、规则、边界、随机数状态）保存为二进制快照
+        """
+        self.env.save_snapshot(str(path))
+
+    def load_snapshot(self, path):
+        """
+        从同尺寸环境保存的快照恢复完整状态，之后的 step 与保存时的环境逐代一致；
+        死亡率、能量等参数仍取自本环境的配置
+        """
+        self.env.load_snapshot(str(path))
+
+    def get_components(self):
+        """
+        获取细胞连通分量（8 邻接），返回形状为 (分量数, 5) 的数组，
+        各列依次为 cells、min_x、min_y、max_x、max_y
+        """
+        return self.env.get_components()
+
+    def get_grid_state(self, out=None):
         """
         获取网格状态（用于可视化）
+        传入形状为 (height, width) 的 bool/uint8 数组时直接写入该数组，每帧复用不再分配
         """
         try:
+            if out is not None:
+                return self.env.get_grid_state_into(out)
             return self.env.get_grid_state()
         except Exception as e:
             print(f"Error getting grid state: {e}")
             return np.array([])
     
+    def get_grid_words(self):
+        """
+        获取位压缩网格的副本，形状为 (height, 每行字数)，第 x 列为第 x // 64 个字的第 x % 64 位
+        """
+        return self.env.get_grid_words()
+
     def get_cells(self):
         """
         获取所有活细胞的具体信息
@@ -160,6 +247,16 @@ ENV_HEIGHT = 100
             print(f"Error getting cell positions: {e}")
             return []
     
+    def get_cells_array(self):
+        """
+        获取所有活细胞的结构化数组（字段 id, x, y, age, energy），适合逐帧调用
+        """
+        try:
+            return self.env.get_cells_array()
+        except Exception as e:
+            print(f"Error getting cell array: {e}")
+            return np.array([])
+
     def reload_config(self):
         """
         重新加载配置
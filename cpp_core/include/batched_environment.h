@@ -0,0 +1,132 @@
+#ifndef BATCHED_ENVIRONMENT_H
+#define BATCHED_ENVIRONMENT_H
+
+#include "game_environment.h"
+#include "thread_pool.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @file batched_environment.h
+ * @brief 批量游戏环境接口声明
+ *
+ * 持有 N 个相互独立的游戏环境，在同一个线程池上并行推进，
+ * 供训练时一次采集多个环境的样本
+ */
+
+/**
+ * @class BatchedGameEnvironment
+ * @brief 批量游戏环境
+ *
+ * 每个环境内部串行演化，并行发生在环境之间。各环境按上一代细胞数从多到少的顺序
+ * 由线程池动态领取，先处理耗时长的环境，细胞数差别很大时各线程的负载也保持均衡。
+ * 所有环境的细胞按环境顺序拼接：第 i 个环境的细胞在拼接结果中占 [offsets[i], offsets[i+1])
+ */
+class BatchedGameEnvironment
+{
+private:
+    std::vector<std::unique_ptr<GameEnvironment>> envs_; ///< 各环境
+    std::unique_ptr<ThreadPool> pool_;                   ///< 常驻线程池（单线程时为空）
+    std::vector<int> order_;                             ///< 环境的领取顺序（细胞多的在前）
+    std::vector<int> offsets_;                           ///< 各环境细胞在拼接结果中的起始位置
+    std::vector<std::vector<int>> moves_;                ///< 拆分到各环境的移动指令（复用）
+
+    /**
+     * @brief 按 order_ 的顺序并行执行 task(env)，单线程时串行执行
+     * @param task 子任务函数，参数为环境下标
+     */
+    void forEachEnv(const std::function<void(int)> &task);
+
+    /**
+     * @brief 按当前细胞数重新排列领取顺序
+     */
+    void sortByLoad();
+
+public:
+    /**
+     * @brief 构造函数
+     * @param num_envs 环境数量
+     * @param width 每个环境的宽度
+     * @param height 每个环境的高度
+     * @param config_file 配置文件路径（所有环境共用）
+     * @param num_threads 并行线程数，0 表示使用硬件线程数
+     * @param seed 随机数种子，第 i 个环境使用 seed + i；负数表示各环境从 std::random_device 取种子
+     */
+    BatchedGameEnvironment(int num_envs, int width, int height, const std::string &config_file = "config.txt",
+                           int num_threads = 0, long long seed = -1);
+
+    /**
+     * @brief 获取环境数量
+     * @return 环境数量
+     */
+    int size() const { return static_cast<int>(envs_.size()); }
+
+    /**
+     * @brief 获取第 i 个环境
+     * @param i 环境下标
+     * @return 环境引用
+     */
+    GameEnvironment &env(int i) { return *envs_[i]; }
+    const GameEnvironment &env(int i) const { return *envs_[i]; }
+
+    /**
+     * @brief 获取并行线程数
+     * @return 线程数，1 表示串行
+     */
+    int getNumThreads() const { return pool_ ? pool_->size() : 1; }
+
+    /**
+     * @brief 重新播种所有环境，第 i 个环境使用 seed + i
+     * @param seed 随机数种子
+     */
+    void seed(uint64_t seed);
+
+    /**
+     * @brief 随机初始化所有环境
+     * @param num_cells 每个环境的初始细胞数量
+     */
+    void initializeRandom(int num_cells);
+
+    /**
+     * @brief 所有环境各演化一代（不带移动）
+     */
+    void update();
+
+    /**
+     * @brief 所有环境各执行一次带移动的更新
+     * @param moves 拼接后的移动指令，按 cellOffsets() 拆分到各环境
+     *
+     * 第 i 个环境使用 moves[offsets[i], offsets[i+1])，长度不足的部分视为不动
+     */
+    void updateWithMoves(const std::vector<int> &moves);
+    void updateWithMoves(const int *moves, int count);
+
+    /**
+     * @brief 计算各环境细胞在拼接结果中的位置
+     * @return N+1 个偏移量，最后一项为细胞总数
+     */
+    const std::vector<int> &cellOffsets();
+
+    /**
+     * @brief 获取拼接后的细胞附近环境状态，各环境直接写入调用方的缓冲区
+     * @param states 输出，至少 cellOffsets().back() * observationSize() 个元素，
+     *               每个细胞占 observationSize() 个元素，按环境顺序连续存放
+     * @return N+1 个偏移量，与 cellOffsets() 相同
+     */
+    const std::vector<int> &getCellStates(float *states);
+
+    /**
+     * @brief 单个细胞状态向量的长度
+     * @return (2 * Vision + 1)^2
+     */
+    int observationSize() const;
+
+    /**
+     * @brief 获取各环境的细胞数量
+     * @return 长度为 N 的细胞数量列表
+     */
+    std::vector<int> getPopulations() const;
+};
+
+#endif // BATCHED_ENVIRONMENT_H
@@ -0,0 +1,174 @@
+#ifndef BIT_GRID_H
+#define BIT_GRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * @file bit_grid.h
+ * @brief 位压缩网格声明
+ *
+ * 以 64 位字为单位连续存储网格状态，每个细胞占 1 bit，
+ * 为按字并行（SWAR）的邻居计数提供底层存储
+ */
+
+/**
+ * @brief 统计 64 位字中置位的个数
+ * @param v 输入字
+ * @return 置位个数
+ */
+inline int popcount64(uint64_t v)
+{
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(v));
+#else
+    return __builtin_popcountll(v);
+#endif
+}
+
+/**
+ * @brief 计算 64 位字末尾 0 的个数
+ * @param v 输入字（不能为 0）
+ * @return 最低置位的下标
+ */
+inline int ctz64(uint64_t v)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, v);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(v);
+#endif
+}
+
+/**
+ * @class BitGrid
+ * @brief 位压缩网格
+ *
+ * 每行由若干 64 位字组成，第 x 列位于第 x/64 个字的第 x%64 位。
+ * 每行的有效字数向上补齐到 kVectorWords 的整数倍，便于 SIMD 核心整向量读写；
+ * 每行左右各有一个保护字，网格上下各有一行保护行，保护区域始终为 0，
+ * 因此邻居计算无需任何边界判断
+ */
+class BitGrid
+{
+public:
+    static const int kVectorWords = 8; ///< 行对齐粒度（AVX-512 一次处理的字数）
+
+private:
+    int width_, height_;         ///< 网格尺寸
+    int words_;                  ///< 每行覆盖宽度所需的字数
+    int padded_;                 ///< 补齐到 kVectorWords 整数倍后的字数
+    int stride_;                 ///< 每行实际占用的字数（含保护字）
+    std::vector<uint64_t> data_; ///< 连续存储的所有行
+
+public:
+    /**
+     * @brief 构造函数
+     * @param width 网格宽度
+     * @param height 网格高度
+     */
+    BitGrid(int width = 0, int height = 0);
+
+    /**
+     * @brief 重新设置网格尺寸并清空
+     * @param width 网格宽度
+     * @param height 网格高度
+     */
+    void resize(int width, int height);
+
+    /**
+     * @brief 清空所有细胞
+     */
+    void clear();
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+    /**
+     * @brief 获取每行覆盖宽度所需的字数
+     * @return 字数
+     */
+    int wordsPerRow() const { return words_; }
+
+    /**
+     * @brief 获取每行补齐后的字数
+     * @return 字数，补齐部分始终为 0
+     */
+    int paddedWordsPerRow() const { return padded_; }
+
+    /**
+     * @brief 获取行跨度
+     * @return 相邻两行首字之间相隔的字数
+     */
+    int stride() const { return stride_; }
+
+    /**
+     * @brief 获取行内最后一个字的有效位掩码
+     * @return 宽度以外的位为 0 的掩码
+     */
+    uint64_t lastWordMask() const
+    {
+        int rem = width_ & 63;
+        return rem == 0 ? ~0ULL : ((1ULL << rem) - 1);
+    }
+
+    /**
+     * @brief 获取第 y 行第一个有效字的指针
+     * @param y 行号，允许为 -1 或 height（保护行）
+     * @return 行首指针，下标 -1 与 paddedWordsPerRow() 为保护字
+     */
+    uint64_t *row(int y) { return data_.data() + static_cast<size_t>(y + 1) * stride_ + 1; }
+    const uint64_t *row(int y) const { return data_.data() + static_cast<size_t>(y + 1) * stride_ + 1; }
+
+    /**
+     * @brief 读取细胞状态（不做边界检查）
+     * @param x 列号
+     * @param y 行号
+     * @return 细胞是否存活
+     */
+    bool get(int x, int y) const
+    {
+        return (row(y)[x >> 6] >> (x & 63)) & 1ULL;
+    }
+
+    /**
+     * @brief 放置细胞（不做边界检查）
+     * @param x 列号
+     * @param y 行号
+     */
+    void set(int x, int y)
+    {
+        row(y)[x >> 6] |= 1ULL << (x & 63);
+    }
+
+    /**
+     * @brief 清除细胞（不做边界检查）
+     * @param x 列号
+     * @param y 行号
+     */
+    void reset(int x, int y)
+    {
+        row(y)[x >> 6] &= ~(1ULL << (x & 63));
+    }
+
+    /**
+     * @brief 统计存活细胞数量
+     * @return 置位总数
+     */
+    int count() const;
+
+    /**
+     * @brief 与另一个网格交换内容
+     * @param other 另一个网格
+     */
+    void swap(BitGrid &other);
+};
+
+#endif // BIT_GRID_H
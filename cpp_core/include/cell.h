@@ -2,36 +2,161 @@
 #define CELL_H
 
 #include "types.h"
+#include <cstdint>
+#include <vector>
 
 /**
  * @file cell.h
- * @brief 细胞类接口声明
+ * @brief 细胞存储与细胞视图接口声明
  *
- * 定义细胞数据结构和基本接口，用于在 C++ 和 Python 间传递细胞信息
+ * 细胞数据按列连续存放在 CellStore 中，Cell 仅作为指向其中一项的轻量视图，
+ * 用于在 C++ 和 Python 间传递细胞信息
  */
 
+/**
+ * @class CellStore
+ * @brief 按列存放的细胞数据（SoA）
+ *
+ * ID、坐标、年龄、能量、存活状态各占一个连续数组，下标相同的元素属于同一个细胞。
+ * clear() 与删除操作都保留已分配的容量，细胞出生时不再单独分配内存
+ */
+class CellStore
+{
+private:
+    std::vector<int> ids_;         ///< 细胞唯一标识符
+    std::vector<int> xs_;          ///< X 坐标
+    std::vector<int> ys_;          ///< Y 坐标
+    std::vector<int> ages_;        ///< 细胞年龄
+    std::vector<double> energies_; ///< 细胞能量
+    std::vector<uint8_t> alive_;   ///< 细胞存活状态
+
+public:
+    /**
+     * @brief 获取细胞数量
+     * @return 细胞数量
+     */
+    int size() const { return static_cast<int>(ids_.size()); }
+
+    /**
+     * @brief 是否没有细胞
+     * @return 没有细胞时返回 true
+     */
+    bool empty() const { return ids_.empty(); }
+
+    /**
+     * @brief 删除全部细胞，保留已分配的容量
+     */
+    void clear();
+
+    /**
+     * @brief 预留容量
+     * @param capacity 细胞数量
+     */
+    void reserve(int capacity);
+
+    /**
+     * @brief 在末尾加入一个新细胞（存活，年龄为 0，能量为 1.0）
+     * @param id 细胞唯一ID
+     * @param pos 初始位置
+     * @return 新细胞的下标
+     */
+    int push(int id, const Position &pos);
+
+    /**
+     * @brief 用连续数组整体替换全部细胞
+     * @param count 细胞数量
+     * @param ids 细胞ID数组，其余数组同样各有 count 个元素
+     *
+     * 每列一次整块拷贝，用于从快照恢复
+     */
+    void assign(int count, const int *ids, const int *xs, const int *ys, const int *ages,
+                const double *energies, const uint8_t *alive);
+
+    /**
+     * @brief 用末尾细胞覆盖第 i 个细胞后删除末尾，O(1)
+     * @param i 细胞下标
+     */
+    void swapRemove(int i);
+
+    // Getter方法 - 按下标访问细胞属性
+
+    int id(int i) const { return ids_[i]; }
+    Position position(int i) const { return Position(xs_[i], ys_[i]); }
+    bool alive(int i) const { return alive_[i] != 0; }
+    int age(int i) const { return ages_[i]; }
+    double energy(int i) const { return energies_[i]; }
+
+    // Setter方法 - 语义与原 Cell 的同名方法一致
+
+    /**
+     * @brief 设置细胞位置
+     * @param i 细胞下标
+     * @param pos 新的位置坐标
+     */
+    void setPosition(int i, const Position &pos)
+    {
+        xs_[i] = pos.x;
+        ys_[i] = pos.y;
+    }
+
+    /**
+     * @brief 设置细胞存活状态，死亡时能量归零、位置与ID无效化
+     * @param i 细胞下标
+     * @param alive 新的存活状态
+     */
+    void setAlive(int i, bool alive);
+
+    /**
+     * @brief 设置细胞能量，能量耗尽时细胞死亡
+     * @param i 细胞下标
+     * @param energy 新的能量值
+     */
+    void setEnergy(int i, double energy);
+
+    /**
+     * @brief 增加细胞年龄
+     * @param i 细胞下标
+     * @param generations 增加的代数
+     */
+    void increaseAge(int i, int generations = 1) { ages_[i] += generations; }
+
+    /**
+     * @brief 消耗细胞能量（不检查是否耗尽）
+     * @param i 细胞下标
+     * @param amount 消耗的能量值
+     */
+    void consumeEnergy(int i, double amount) { energies_[i] -= amount; }
+
+    // 连续数组 - 供逐细胞的批量处理与 Python 端拷贝使用
+
+    const int *idData() const { return ids_.data(); }
+    const int *xData() const { return xs_.data(); }
+    const int *yData() const { return ys_.data(); }
+    const int *ageData() const { return ages_.data(); }
+    const double *energyData() const { return energies_.data(); }
+    const uint8_t *aliveData() const { return alive_.data(); }
+};
+
 /**
  * @class Cell
- * @brief 细胞数据容器类
+ * @brief 指向 CellStore 中一个细胞的轻量视图
  *
- * 存储细胞的基本状态信息，通过 getCells 方法暴露给 Python 端
+ * 保留原 Cell 的接口以兼容旧代码，只持有存储指针和下标，
+ * 存储中的细胞被删除或交换位置后视图即失效
  */
 class Cell
 {
 private:
-    int id_;            ///< 细胞唯一标识符
-    Position position_; ///< 细胞位置坐标
-    bool alive_;        ///< 细胞存活状态
-    int age_;           ///< 细胞年龄
-    double energy_;     ///< 细胞能量
+    CellStore *store_; ///< 所属存储
+    int index_;        ///< 细胞下标
 
 public:
     /**
      * @brief 构造函数
-     * @param id 细胞唯一ID
-     * @param pos 初始位置
+     * @param store 所属存储
+     * @param index 细胞下标
      */
-    Cell(int id, Position pos);
+    Cell(CellStore &store, int index) : store_(&store), index_(index) {}
 
     // Getter方法 - 提供对细胞属性的只读访问
 
@@ -39,31 +164,31 @@ public:
      * @brief 获取细胞ID
      * @return 细胞唯一标识符
      */
-    int getId() const { return id_; }
+    int getId() const { return store_->id(index_); }
 
     /**
      * @brief 获取细胞位置
      * @return 细胞当前位置
      */
-    Position getPosition() const { return position_; }
+    Position getPosition() const { return store_->position(index_); }
 
     /**
      * @brief 检查细胞是否存活
      * @return 存活状态（true=存活，false=死亡）
      */
-    bool isAlive() const { return alive_; }
+    bool isAlive() const { return store_->alive(index_); }
 
     /**
      * @brief 获取细胞年龄
      * @return 细胞年龄
      */
-    int getAge() const { return age_; }
+    int getAge() const { return store_->age(index_); }
 
     /**
      * @brief 获取细胞能量
      * @return 细胞能量值
      */
-    double getEnergy() const { return energy_; }
+    double getEnergy() const { return store_->energy(index_); }
 
     // Setter方法 - 允许修改细胞状态
 
@@ -71,30 +196,36 @@ public:
      * @brief 设置细胞位置
      * @param pos 新的位置坐标
      */
-    void setPosition(const Position &pos) { position_ = pos; }
+    void setPosition(const Position &pos) { store_->setPosition(index_, pos); }
 
     /**
      * @brief 设置细胞存活状态
      * @param alive 新的存活状态
      */
-    void setAlive(bool alive);
+    void setAlive(bool alive) { store_->setAlive(index_, alive); }
 
     /**
      * @brief 设置细胞能量
      * @param energy 新的能量值
      */
-    void setEnergy(double energy);
+    void setEnergy(double energy) { store_->setEnergy(index_, energy); }
 
     /**
      * @brief 增加细胞年龄
      */
-    void increaseAge() { age_++; }
+    void increaseAge() { store_->increaseAge(index_); }
+
+    /**
+     * @brief 一次增加多代的年龄
+     * @param generations 增加的代数
+     */
+    void increaseAge(int generations) { store_->increaseAge(index_, generations); }
 
     /**
      * @brief 消耗细胞能量
      * @param amount 消耗的能量值
      */
-    void consumeEnergy(double amount) { energy_ -= amount; }
+    void consumeEnergy(double amount) { store_->consumeEnergy(index_, amount); }
 };
 
 #endif // CELL_H
@@ -0,0 +1,81 @@
+#ifndef COMPONENT_LABELER_H
+#define COMPONENT_LABELER_H
+
+#include "types.h"
+#include "bit_grid.h"
+#include "thread_pool.h"
+#include <vector>
+
+/**
+ * @file component_labeler.h
+ * @brief 连通分量标记声明
+ *
+ * 在位压缩网格上按行段（一行内连续的活细胞）做两遍并查集标记，
+ * 代替逐格 BFS，供 newDensity() 与分量分析使用
+ */
+
+/**
+ * @class ComponentLabeler
+ * @brief 行段并查集连通分量标记器
+ *
+ * 网格按行带划分，各行带并行提取行段并合并带内相邻两行的接触行段；
+ * 再串行合并行带接缝两侧的行段，最后按行优先顺序为每个根编号并统计细胞数与包围盒。
+ * 分量按其行优先顺序最靠前的细胞排序，与逐格扫描发现分量的顺序一致
+ */
+class ComponentLabeler
+{
+private:
+    /**
+     * @struct RowRun
+     * @brief 一行内连续的活细胞 [x0, x1]
+     */
+    struct RowRun
+    {
+        int y, x0, x1;
+    };
+
+    /**
+     * @struct Band
+     * @brief 一个行带的局部标记结果
+     */
+    struct Band
+    {
+        std::vector<RowRun> runs; ///< 按行优先顺序排列的行段
+        std::vector<int> parent;  ///< 带内并查集（局部下标）
+        int first_row_end;        ///< 首行行段为 [0, first_row_end)
+        int last_row_begin;       ///< 末行行段为 [last_row_begin, runs.size())
+    };
+
+    std::vector<Band> bands_;               ///< 各行带（复用）
+    std::vector<RowRun> runs_;              ///< 拼接后的全部行段
+    std::vector<int> parent_;               ///< 全局并查集
+    std::vector<int> label_;                ///< 根行段对应的分量编号（非根为 -1）
+    std::vector<ComponentInfo> components_; ///< 标记结果
+
+    /**
+     * @brief 提取 [y0, y1) 行的行段并合并带内相邻行
+     * @param grid 网格
+     * @param y0 起始行
+     * @param y1 结束行（不含）
+     * @param band 输出的行带结果
+     */
+    static void labelBand(const BitGrid &grid, int y0, int y1, Band &band);
+
+public:
+    /**
+     * @brief 标记网格的全部连通分量
+     * @param grid 网格
+     * @param band_rows 每个行带的行数
+     * @param pool 线程池，为空时串行执行
+     * @return 各分量的统计
+     */
+    const std::vector<ComponentInfo> &label(const BitGrid &grid, int band_rows, ThreadPool *pool);
+
+    /**
+     * @brief 获取最近一次标记的结果
+     * @return 各分量的统计
+     */
+    const std::vector<ComponentInfo> &components() const { return components_; }
+};
+
+#endif // COMPONENT_LABELER_H
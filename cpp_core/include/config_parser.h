@@ -24,8 +24,10 @@ private:
     std::string config_file_path_;                     ///< 配置文件路径
     std::unordered_map<std::string, int> i_config_map; ///< 整型配置映射
     std::unordered_map<std::string, int> f_config_map; ///< 浮点型配置映射
-    int i_config[7] = {0};
+    std::unordered_map<std::string, int> s_config_map; ///< 字符串配置映射
+    int i_config[9] = {0};
     double f_config[4] = {0.0};
+    std::string s_config[3];
 
 public:
     /**
@@ -64,6 +66,14 @@ public:
      */
     double getDouble(const std::string &key, double default_value) const;
 
+    /**
+     * @brief 获取字符串配置值
+     * @param key 配置键名
+     * @param default_value 默认值
+     * @return 配置值或默认值
+     */
+    std::string getString(const std::string &key, const std::string &default_value) const;
+
     /**
      * @brief 设置整型配置值
      * @param key 配置键名
@@ -78,6 +88,13 @@ public:
      */
     void setDouble(const std::string &key, double value);
 
+    /**
+     * @brief 设置字符串配置值
+     * @param key 配置键名
+     * @param value 配置值
+     */
+    void setString(const std::string &key, const std::string &value);
+
     /**
      * @brief 检查配置键是否存在
      * @param key 配置键名
@@ -4,6 +4,15 @@
 #include "types.h"
 #include "config_parser.h"
 #include "cell.h"
+#include "bit_grid.h"
+#include "step_kernel.h"
+#include "lut_stepper.h"
+#include "component_labeler.h"
+#include "thread_pool.h"
+#include "hashlife.h"
+#include "rng.h"
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 #include <memory>
 
@@ -27,13 +36,128 @@ private:
     int Live_min, Live_max;                    ///< 存活邻居数范围
     int Breed_min, Breed_max;                  ///< 繁殖邻居数范围
     int Vision;                                ///< 细胞视野范围
+    std::string Rule;                          ///< B/S 规则串（为空时使用邻居数范围）
     double Death_Rate;                         ///< 细胞死亡概率
     double Energy_consumption;                 ///< 细胞能量消耗率
     double Restore_prob;                       ///< 细胞能量恢复概率
     double Restore_value;                      ///< 细胞能量恢复值
+    uint32_t survive_mask_, birth_mask_;       ///< 由邻居数范围生成的规则掩码
     ConfigParser config_;                      ///< 配置管理器
-    std::vector<std::vector<bool>> grid_;      ///< 网格状态
-    std::vector<std::shared_ptr<Cell>> cells_; ///< 细胞列表
+    BitGrid grid_;                             ///< 位压缩网格状态（当前代）
+    BitGrid next_grid_;                        ///< 下一代网格（与 grid_ 交替使用）
+    const StepKernel *kernel_;                 ///< 启动时按 CPUID 选出的演化核心
+    LutStepper lut_;                           ///< 查表演化引擎（KERNEL = lut 时使用）
+    bool use_lut_;                             ///< 是否使用查表引擎代替 SIMD 核心
+    bool wrap_;                                ///< 边界是否环绕（BOUNDARY = wrap），否则边界外视为空
+    CellStore cells_;                          ///< 细胞列表（按列连续存放）
+    std::vector<int> cell_slot_;               ///< 每个位置的细胞在 cells_ 中的下标（无细胞为 -1）
+    int next_id_;                              ///< 下一个新细胞的 ID（单调递增）
+    int population_;                           ///< 网格中的活细胞数（随出生、死亡增量维护）
+    StepStats last_stats_;                     ///< 最近一次演化的变化量
+    std::vector<int> move_claim_;              ///< 每个目标格当前胜出的细胞下标（无登记为 -1）
+    std::vector<int> claimed_targets_;         ///< 本回合被登记过的目标格
+    uint64_t seed_;                            ///< 随机数种子
+    uint64_t generation_;                      ///< 已演化的代数，用于派生每代的随机数流
+    Rng rng_;                                  ///< 环境主随机数引擎（随机初始化等串行操作使用）
+    mutable ComponentLabeler labeler_;             ///< 连通分量标记器（复用缓冲区）
+    mutable bool components_valid_;                ///< labeler_ 的结果是否对应当前网格
+    mutable std::vector<uint8_t> obs_grid_;        ///< 四周各补 Vision 格空白的逐格网格，供 getCellStates() 使用（复用）
+    int num_threads_;                          ///< 演化使用的线程数
+    std::unique_ptr<ThreadPool> pool_;         ///< 常驻线程池（单线程时为空）
+    std::vector<std::vector<Position>> band_births_; ///< 各行带收集的出生位置
+    std::vector<std::vector<Position>> band_deaths_; ///< 各行带收集的死亡位置
+    std::vector<Position> doomed_;                   ///< 本代必然死亡的细胞（能量耗尽或随机死亡）
+
+    static const int kTileShift = 6;             ///< 活跃块边长的对数
+    static const int kTileSize = 1 << kTileShift; ///< 活跃块边长（64，宽度恰为一个字）
+    int tiles_x_, tiles_y_;                      ///< 活跃块的列数与行数
+    std::vector<uint8_t> tile_changed_;          ///< 块在上一代是否变化（grid_ 与 next_grid_ 不一致）
+    std::vector<uint8_t> tile_active_;           ///< 块在本代是否需要计算
+    std::unique_ptr<HashLife> hashlife_;         ///< 纯规则演化引擎（首次使用时创建）
+    static const int kRngChunk = 4096;           ///< 每条随机数流负责的细胞数（与线程数无关）
+    static const int kHashLifeMinGenerations = 64; ///< advance() 使用 HashLife 的最少代数
+    static const int kHashLifeProbe = 16;          ///< 判断局面是否混沌的试探跳跃代数
+
+    /**
+     * @brief 将 [0, count) 个子任务分发到线程池，单线程时串行执行
+     * @param count 子任务数量
+     * @param task 子任务函数
+     */
+    void parallelFor(int count, const std::function<void(int)> &task) const;
+
+    /**
+     * @brief 标记位置所在的块已变化
+     * @param x 列号
+     * @param y 行号
+     */
+    void markTile(int x, int y) { tile_changed_[(y >> kTileShift) * tiles_x_ + (x >> kTileShift)] = 1; }
+
+    /**
+     * @brief 在网格上放置/清除细胞并标记所在块
+     * @param x 列号
+     * @param y 行号
+     *
+     * 所有对 grid_ 的外部修改都必须经过这两个函数，否则活跃块会漏算
+     */
+    void gridSet(int x, int y);
+    void gridReset(int x, int y);
+
+    /**
+     * @brief 由上一代变化的块计算本代活跃块（变化块及其八邻域，环绕边界时邻域跨越对边）
+     */
+    void computeActiveTiles();
+
+    /**
+     * @brief 环绕边界时把对边的细胞写入 grid_ 的保护区域，演化核心无需区分边界
+     *
+     * 左保护字最高位为第 width-1 列，第 width 位为第 0 列，上下保护行为对侧整行。
+     * 写入的位可能位于最后一个字的宽度以外，演化后必须调用 clearHalo() 清除
+     */
+    void fillHalo();
+
+    /**
+     * @brief 清除 fillHalo() 写入的位，恢复保护区域与宽度以外的位为 0
+     */
+    void clearHalo();
+
+    /**
+     * @brief 按当前规则掩码选择演化核心，使用查表引擎时重建查找表
+     */
+    void selectKernel();
+
+    /**
+     * @brief 用 HashLife 引擎推进若干代并同步细胞列表
+     * @param generations 推进的代数
+     *
+     * last_stats_ 为首末两代之间的出生与死亡数
+     */
+    void advanceHashLife(long long generations);
+
+    /**
+     * @brief 逐细胞取出视野并交给 write 写入输出
+     * @param write 调用形式为 write(i, src, stride)：src 指向第 i 个细胞视野左上角的逐格 0/1，
+     *              相邻两行相隔 stride 个字节
+     *
+     * 网格先展开到四周补白的逐格网格中，视野读取不再逐元素判断边界；细胞分段后并行处理
+     */
+    template <class Writer>
+    void writeCellWindows(const Writer &write) const;
+
+    /**
+     * @brief 只维护细胞列表与位置索引，不修改网格
+     * @param pos 细胞位置
+     *
+     * 删除时用末尾细胞填补空位，两者均为 O(1)
+     */
+    void addCellRecord(const Position &pos);
+    bool removeCellRecord(const Position &pos);
+
+    /**
+     * @brief 移动第 i 个细胞并更新位置索引，不修改网格
+     * @param i 细胞下标
+     * @param to 目标位置
+     */
+    void moveCellRecord(int i, const Position &to);
 
 public:
     /**
@@ -41,14 +165,51 @@ public:
      * @param width 环境宽度
      * @param height 环境高度
      * @param config_file 配置文件路径
+     * @param num_threads 演化使用的线程数，0 表示读取配置项 THREADS（默认 1，即串行）
+     * @param seed 随机数种子，负数表示从 std::random_device 取种子
+     */
+    GameEnvironment(int width, int height, const std::string &config_file = "config.txt", int num_threads = 0,
+                    long long seed = -1);
+
+    /**
+     * @brief 重新播种，之后的随机初始化与演化可完整复现
+     * @param seed 随机数种子
      */
-    GameEnvironment(int width, int height, const std::string &config_file = "config.txt");
+    void seed(uint64_t seed);
+
+    /**
+     * @brief 获取随机数种子
+     * @return 构造时或最近一次 seed() 使用的种子
+     */
+    uint64_t getSeed() const { return seed_; }
+
+    /**
+     * @brief 把完整状态写入快照文件
+     * @param path 文件路径
+     * @return 写入成功时返回 true
+     *
+     * 保存网格、细胞数组、规则、边界模式、种子、代数与随机数引擎状态，格式见 snapshot.h
+     */
+    bool saveSnapshot(const std::string &path) const;
+
+    /**
+     * @brief 从快照文件恢复完整状态
+     * @param path 文件路径
+     * @return 恢复成功时返回 true；文件无效、尺寸与本环境不同或细胞与网格不一致时状态不变并返回 false
+     *
+     * 文件以 mmap 映射，先校验每个细胞都位于不重复的活细胞位上且每个活细胞位都有细胞，
+     * 再按段整块拷贝到网格与细胞数组，恢复后的演化与保存时的环境逐代一致
+     */
+    bool loadSnapshot(const std::string &path);
 
     // 以下方法在 PyBind11 绑定中被直接调用
 
     /**
      * @brief 随机初始化环境
-     * @param num_cells 初始细胞数量
+     * @param num_cells 初始细胞数量，超过网格面积时填满网格
+     *
+     * 用 Floyd 算法在全部位置中不放回地抽取恰好 num_cells 个，网格本身作为已选集合；
+     * 超过一半面积时先填满再抽取要清空的位置。细胞按行优先顺序批量加入细胞列表
      */
     void initializeRandom(int num_cells);
 
@@ -57,9 +218,48 @@ public:
      */
     void update();
 
+    /**
+     * @brief 连续推进若干代，等价于调用 generations 次 update()
+     * @param generations 推进的代数
+     *
+     * 处于纯规则模式（isPureRule() 为真）且代数不少于 kHashLifeMinGenerations 时，
+     * 先用 HashLife 试探跳跃 kHashLifeProbe 代：每代新建节点数相对网格面积较少时用 HashLife
+     * 一次跳跃 2^k 代推进剩余代数；局面混沌（记忆几乎无法复用）时改为逐代调用 update()。
+     * 其余情况逐代调用 update()
+     */
+    void advance(long long generations);
+
+    /**
+     * @brief 在 C++ 端连续演化至多 generations 代，逐代记录统计
+     * @param generations 最多演化的代数
+     * @param options 提前结束条件
+     * @return 每一代结束时的统计，长度即实际演化的代数
+     *
+     * 每代调用一次 update()，满足结束条件的那一代也会被记录
+     */
+    std::vector<StepRecord> run(int generations, const RunOptions &options = RunOptions());
+
+    /**
+     * @brief 当前演化是否只由规则决定
+     * @return 死亡概率与能量恢复均关闭且没有能量耗尽的细胞时返回 true
+     */
+    bool isPureRule() const;
+
+    /**
+     * @brief 更换演化规则
+     * @param rule B/S 规则串（如 "B36/S23"）
+     * @return 规则串格式正确时返回 true，否则规则保持不变并返回 false
+     *
+     * 重新选择演化核心（查表引擎会重建查找表），并丢弃按旧规则缓存的 HashLife 引擎
+     */
+    bool setRule(const std::string &rule);
+
     /**
      * @brief 带移动的更新
      * @param moves 细胞移动指令列表
+     *
+     * 所有移动同时生效：目标格须在本回合开始时为空，
+     * 多个细胞挤入同一格时能量最高者进入，其余细胞原地不动
      */
     void updateWithMoves(const std::vector<int> &moves);
 
@@ -69,11 +269,75 @@ public:
      */
     std::vector<std::vector<float>> getCellStates() const;
 
+    /**
+     * @brief 将所有细胞附近环境状态写入调用方提供的缓冲区
+     * @param out 输出缓冲区，至少 getCells().size() * getObservationSize() 个元素，
+     *            第 i 个细胞的视野按行优先占 [i * n, (i + 1) * n)
+     *
+     * 先把网格展开到四周补白的逐格网格中，视野复制不再逐元素判断边界；
+     * 细胞分段后并行写入，结果与 getCellStates() 一致
+     */
+    void getCellStates(float *out) const;
+
+    /**
+     * @brief 同 getCellStates(float *)，每个元素占 1 字节（0/1）
+     * @param out 输出缓冲区，至少 getCells().size() * getObservationSize() 字节
+     */
+    void getCellStates(uint8_t *out) const;
+
+    /**
+     * @brief 按位压缩的细胞附近环境状态
+     * @param out 输出缓冲区，至少 getCells().size() * getPackedObservationSize() 字节
+     *
+     * 视野第 k 个元素（行优先）存放在该细胞第 k/8 个字节的第 k%8 位，
+     * 与 numpy.unpackbits(bitorder="little") 的约定一致
+     */
+    void getPackedCellStates(uint8_t *out) const;
+
+    /**
+     * @brief 将按位压缩的状态展开为浮点数
+     * @param packed 压缩状态，每个细胞占 (obs_size + 7) / 8 字节
+     * @param count 细胞数量
+     * @param obs_size 每个细胞的视野元素个数
+     * @param out 输出缓冲区，至少 count * obs_size 个元素
+     */
+    static void unpackCellStates(const uint8_t *packed, int count, int obs_size, float *out);
+
+    /**
+     * @brief 单个细胞视野的元素个数
+     * @return (2 * Vision + 1)^2
+     */
+    int getObservationSize() const
+    {
+        int side = 2 * std::max(Vision, 0) + 1;
+        return side * side;
+    }
+
+    /**
+     * @brief 单个细胞压缩视野的字节数
+     * @return (getObservationSize() + 7) / 8
+     */
+    int getPackedObservationSize() const { return (getObservationSize() + 7) / 8; }
+
     /**
      * @brief 获取网格状态
      * @return 网格状态矩阵
      */
     std::vector<std::vector<bool>> getGridState() const;
+
+    /**
+     * @brief 将网格状态写入调用方提供的缓冲区
+     * @param out 输出缓冲区，至少 width * height 字节，按行优先写入 0/1
+     *
+     * 直接按字展开位压缩网格，不产生中间容器
+     */
+    void getGridState(uint8_t *out) const;
+
+    /**
+     * @brief 获取当前代的位压缩网格
+     * @return 网格的常量引用，供零拷贝读取；演化会交换缓冲区，引用的内容在下一次演化前有效
+     */
+    const BitGrid &getGrid() const { return grid_; }
     /**
      * @brief 获取空邻居位置
      * @param pos 中心位置
@@ -110,24 +374,69 @@ public:
      */
     int getHeight() const { return height_; }
 
+    /**
+     * @brief 获取细胞视野范围
+     * @return 视野半径，细胞状态向量长度为 (2 * Vision + 1)^2
+     */
+    int getVision() const { return Vision; }
+
+    /**
+     * @brief 获取边界模式
+     * @return "wrap"（环绕）或 "dead"（边界外为空）
+     */
+    const char *getBoundary() const { return wrap_ ? "wrap" : "dead"; }
+
+    /**
+     * @brief 获取正在使用的演化核心名称
+     * @return "scalar"、"sse2"、"avx2"、"avx512"，使用查表引擎时为 "lut"
+     */
+    const char *getKernelName() const { return use_lut_ ? "lut" : kernel_->name; }
+
+    /**
+     * @brief 获取演化核心特化的规则
+     * @return 规则串（如 "B3/S23"），使用通用版本时为 "generic"，使用查表引擎时为 "table"
+     */
+    const char *getKernelRule() const { return use_lut_ ? "table" : kernel_->rule; }
+
+    /**
+     * @brief 获取演化使用的线程数
+     * @return 线程数，1 表示串行
+     */
+    int getNumThreads() const { return num_threads_; }
+
     /**
      * @brief 获取细胞数量
-     * @return 当前细胞数量
+     * @return 当前细胞数量，O(1)
      */
     int getPopulation() const;
 
     /**
      * @brief 获取细胞密度
-     * @return 细胞密度值
+     * @return 细胞密度值，O(1)
      */
     float getDensity() const;
 
+    /**
+     * @brief 获取最近一次演化的变化量
+     * @return update()/updateWithMoves() 为这一代的出生、死亡与移动数；
+     *         advance() 为整段推进的累计出生与死亡数
+     */
+    const StepStats &getStepStats() const { return last_stats_; }
+
     /**
      * @brief 更精确的密度计算
-     * @return 细胞密度值
+     * @return 各连通分量（细胞数 / 包围盒面积）的平均值
      */
     float newDensity() const;
 
+    /**
+     * @brief 获取当前网格的连通分量（8 邻接）
+     * @return 各分量的细胞数与包围盒，按分量中行优先顺序最靠前的细胞排序
+     *
+     * 结果在网格变化前缓存，同一代内多次调用只标记一次
+     */
+    const std::vector<ComponentInfo> &getComponents() const;
+
     // 配置管理方法 - 在 Python 绑定中使用
 
     /**
@@ -142,12 +451,19 @@ public:
 
     /**
      * @brief 获取环境中所有细胞的列表
-     * @return 包含所有细胞智能指针的常量引用
+     * @return 细胞存储的常量引用
      *
      * 这个方法在PyBind11绑定中被get_cell_positions方法调用
      * 用于获取细胞的详细信息并返回给Python端
      */
-    const std::vector<std::shared_ptr<Cell>> &getCells() const;
+    const CellStore &getCells() const;
+
+    /**
+     * @brief 获取第 i 个细胞的视图
+     * @param i 细胞下标
+     * @return 细胞视图，细胞列表变化后失效
+     */
+    Cell getCell(int i) { return Cell(cells_, i); }
     void setCell(Position pos);
 
     /**
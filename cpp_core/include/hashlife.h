@@ -0,0 +1,117 @@
+#ifndef HASHLIFE_H
+#define HASHLIFE_H
+
+#include "bit_grid.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file hashlife.h
+ * @brief HashLife 演化引擎声明
+ *
+ * 用带记忆的四叉树一次推进 2^k 代，适用于无移动、无随机事件的纯规则演化
+ */
+
+/**
+ * @class HashLife
+ * @brief 基于哈希共享四叉树的演化引擎
+ *
+ * 叶子节点有三种状态：死、活、墙。网格之外的区域用墙填充，
+ * 墙永远不会存活也不计入邻居，因此有限网格“边界外视为无细胞”的语义得以精确保留。
+ * 3 级节点（8x8）作为递归基，用 64 位位图逐格计算；
+ * 节点以下标引用，节点缓存超过上限时在两次推进之间做一次标记-整理式垃圾回收
+ */
+class HashLife
+{
+private:
+    /**
+     * @struct Node
+     * @brief 四叉树节点
+     */
+    struct Node
+    {
+        uint32_t nw, ne, sw, se; ///< 四个子节点（叶子节点无意义）
+        uint32_t next;           ///< 哈希链表中的下一个节点
+        uint32_t result;         ///< 全速推进 2^(level-2) 代后的中心节点（未计算时为 kNone）
+        uint32_t bits;           ///< 2 级及以下节点的位图：低 16 位为活细胞，高 16 位为墙（行优先）
+        uint8_t level;           ///< 层级，边长为 2^level
+        uint8_t alive;           ///< 子树中是否含有活细胞
+    };
+
+    static const uint32_t kNone = 0xFFFFFFFFu; ///< 空下标
+    static const uint32_t kDead = 0;           ///< 死细胞叶子
+    static const uint32_t kAlive = 1;          ///< 活细胞叶子
+    static const uint32_t kWall = 2;           ///< 墙叶子
+
+    uint32_t survive_mask_, birth_mask_;                ///< 规则掩码
+    size_t max_nodes_;                                  ///< 节点缓存上限
+    std::vector<Node> nodes_;                           ///< 节点池
+    std::vector<uint32_t> buckets_;                     ///< 哈希桶
+    std::vector<uint32_t> wall_nodes_;                  ///< 各层级的全墙节点
+    std::vector<uint32_t> dead_nodes_;                  ///< 各层级的全死节点
+    std::unordered_map<uint64_t, uint32_t> slow_memo_;  ///< 非全速推进的记忆（键为节点与步长）
+    unsigned long long created_;                        ///< 累计新建的节点数（垃圾回收不减少）
+
+    size_t hashOf(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se) const;
+    void rehash(size_t bucket_count);
+    uint32_t makeNode(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se);
+    uint32_t wallNode(int level);
+    uint32_t deadNode(int level);
+    uint32_t centre(uint32_t n);
+    uint32_t expand(uint32_t n);
+    uint32_t fromBits(uint32_t bits);
+    uint32_t baseStep(uint32_t n, int generations);
+    uint32_t successor(uint32_t n, int j);
+    uint32_t build(const BitGrid &grid, int level, int x0, int y0);
+    void extract(uint32_t n, BitGrid &grid, int x0, int y0) const;
+    uint32_t collect(uint32_t root);
+    void reset();
+
+public:
+    /**
+     * @brief 构造函数
+     * @param survive_mask 存活规则掩码
+     * @param birth_mask 繁殖规则掩码
+     * @param max_nodes 节点缓存上限
+     */
+    HashLife(uint32_t survive_mask, uint32_t birth_mask, size_t max_nodes);
+
+    /**
+     * @brief 修改规则，清空全部缓存
+     * @param survive_mask 存活规则掩码
+     * @param birth_mask 繁殖规则掩码
+     */
+    void setRule(uint32_t survive_mask, uint32_t birth_mask);
+
+    /**
+     * @brief 设置节点缓存上限
+     * @param max_nodes 节点数上限
+     */
+    void setMaxNodes(size_t max_nodes) { max_nodes_ = max_nodes; }
+
+    /**
+     * @brief 获取当前缓存的节点数
+     * @return 节点数
+     */
+    size_t nodeCount() const { return nodes_.size(); }
+
+    /**
+     * @brief 获取累计新建的节点数
+     * @return 自构造以来新建的节点数，两次读数之差反映期间演化的“新颖程度”
+     */
+    unsigned long long createdCount() const { return created_; }
+
+    /**
+     * @brief 将网格原地推进若干代
+     * @param grid 网格，边界外视为无细胞
+     * @param generations 推进的代数
+     *
+     * 按代数的二进制位分解为若干次 2^j 代的跳跃，每次跳跃之间检查缓存上限。
+     * 单次跳跃的递归中不做垃圾回收，节点数可能暂时超过上限
+     */
+    void advance(BitGrid &grid, unsigned long long generations);
+};
+
+#endif // HASHLIFE_H
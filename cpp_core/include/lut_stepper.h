@@ -0,0 +1,67 @@
+#ifndef LUT_STEPPER_H
+#define LUT_STEPPER_H
+
+#include "bit_grid.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file lut_stepper.h
+ * @brief 查表演化引擎声明
+ *
+ * 以 4x4 的细胞块为下标查预先计算的表，一次得到中心 2x2 块的下一代状态，
+ * 不依赖任何 SIMD 指令集
+ */
+
+/**
+ * @class LutStepper
+ * @brief 4x4 块查表演化引擎
+ *
+ * 表共 65536 项，下标第 4r+c 位为块内第 r 行第 c 列的细胞（块左上角位于输出块左上角的 (-1, -1)），
+ * 每项低 4 位依次为输出块 (0,0)、(1,0)、(0,1)、(1,1) 的下一代状态。
+ * 表只与规则有关，规则变化时需调用 build() 重建
+ */
+class LutStepper
+{
+private:
+    uint32_t survive_mask_, birth_mask_; ///< 建表时的规则掩码
+    std::vector<uint8_t> table_;         ///< 4x4 块到 2x2 块的查找表
+
+public:
+    static const int kTableSize = 1 << 16; ///< 查找表项数
+
+    LutStepper();
+
+    /**
+     * @brief 按规则建表，规则与上次相同时直接返回
+     * @param survive_mask 存活规则掩码
+     * @param birth_mask 繁殖规则掩码
+     */
+    void build(uint32_t survive_mask, uint32_t birth_mask);
+
+    /**
+     * @brief 是否已按给定规则建表
+     * @param survive_mask 存活规则掩码
+     * @param birth_mask 繁殖规则掩码
+     * @return 表可直接用于该规则时返回 true
+     */
+    bool builtFor(uint32_t survive_mask, uint32_t birth_mask) const
+    {
+        return !table_.empty() && survive_mask_ == survive_mask && birth_mask_ == birth_mask;
+    }
+
+    /**
+     * @brief 计算 [y0, y1) 行、[w0, w1) 字的下一代状态
+     * @param cur 当前网格
+     * @param next 下一代网格
+     * @param y0 起始行
+     * @param y1 结束行（不含）
+     * @param w0 起始字
+     * @param w1 结束字（不含）
+     *
+     * 与 StepKernel::step 的约定相同：只写入给定范围，宽度以外的位保持为 0
+     */
+    void step(const BitGrid &cur, BitGrid &next, int y0, int y1, int w0, int w1) const;
+};
+
+#endif // LUT_STEPPER_H
@@ -0,0 +1,196 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * @file rng.h
+ * @brief 可播种的快速随机数引擎
+ *
+ * xoshiro256** 引擎，状态由 splitmix64 从 64 位种子展开。
+ * 调用频繁，全部定义为内联函数
+ */
+
+/**
+ * @brief splitmix64 混合函数
+ * @param x 输入
+ * @return 混合后的 64 位值，相邻输入的输出互不相关
+ */
+inline uint64_t splitmix64(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @class Rng
+ * @brief xoshiro256** 随机数引擎
+ *
+ * 同一种子产生的序列在所有平台上相同。并行任务用 forStream() 按
+ * (种子, 代数, 子任务编号) 派生互相独立的流，结果与线程数无关
+ */
+class Rng
+{
+private:
+    uint64_t s_[4]; ///< 引擎状态（不全为 0）
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+public:
+    /**
+     * @brief 构造函数
+     * @param seed 种子
+     */
+    explicit Rng(uint64_t seed = 0) { this->seed(seed); }
+
+    /**
+     * @brief 重新播种
+     * @param seed 种子
+     */
+    void seed(uint64_t seed)
+    {
+        // splitmix64 的输出序列不会连续四个为 0，状态必然有效
+        for (int i = 0; i < 4; i++)
+        {
+            seed += 0x9E3779B97F4A7C15ULL;
+            s_[i] = splitmix64(seed);
+        }
+    }
+
+    /**
+     * @brief 读取/恢复引擎状态（用于快照）
+     * @param state 4 个字的状态，恢复时不能全为 0
+     */
+    void getState(uint64_t state[4]) const { std::copy(s_, s_ + 4, state); }
+    void setState(const uint64_t state[4]) { std::copy(state, state + 4, s_); }
+
+    /**
+     * @brief 派生独立的随机数流
+     * @param seed 环境种子
+     * @param generation 代数
+     * @param stream 子任务编号
+     * @return 只由三个参数决定的引擎
+     */
+    static Rng forStream(uint64_t seed, uint64_t generation, uint64_t stream)
+    {
+        return Rng(splitmix64(splitmix64(splitmix64(seed) ^ generation) ^ stream));
+    }
+
+    /**
+     * @brief 生成下一个 64 位随机数
+     * @return 随机数
+     */
+    uint64_t next()
+    {
+        const uint64_t result = rotl(s_[1] * 5, 7) * 9;
+        const uint64_t t = s_[1] << 17;
+        s_[2] ^= s_[0];
+        s_[3] ^= s_[1];
+        s_[1] ^= s_[2];
+        s_[0] ^= s_[3];
+        s_[2] ^= t;
+        s_[3] = rotl(s_[3], 45);
+        return result;
+    }
+
+    /**
+     * @brief 生成 [0, 1) 内均匀分布的浮点数
+     * @return 随机数（53 位精度）
+     */
+    double nextDouble() { return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0); }
+
+    /**
+     * @brief 生成 [0, n) 内均匀分布的整数
+     * @param n 上界，需大于 0
+     * @return 随机数
+     *
+     * 取 32 位随机数与 n 相乘的高 32 位（Lemire 方法），拒绝少量低位落入偏差区间的结果，分布无偏
+     */
+    uint32_t nextInt(uint32_t n)
+    {
+        uint64_t m = (next() >> 32) * n;
+        uint32_t low = static_cast<uint32_t>(m);
+        if (low < n)
+        {
+            const uint32_t threshold = (0u - n) % n;
+            while (low < threshold)
+            {
+                m = (next() >> 32) * n;
+                low = static_cast<uint32_t>(m);
+            }
+        }
+        return static_cast<uint32_t>(m >> 32);
+    }
+
+    /**
+     * @brief 生成 [0, n) 内均匀分布的 64 位整数
+     * @param n 上界，需大于 0
+     * @return 随机数
+     *
+     * n 不超过 2^32 - 1 时与 nextInt() 完全相同；更大的 n 取不小于 n 的 2 的幂作掩码，
+     * 拒绝不小于 n 的结果，期望抽取次数小于 2，分布无偏
+     */
+    uint64_t nextInt64(uint64_t n)
+    {
+        if (n <= 0xFFFFFFFFULL)
+        {
+            return nextInt(static_cast<uint32_t>(n));
+        }
+        uint64_t mask = n - 1;
+        mask |= mask >> 1;
+        mask |= mask >> 2;
+        mask |= mask >> 4;
+        mask |= mask >> 8;
+        mask |= mask >> 16;
+        mask |= mask >> 32;
+        uint64_t r;
+        do
+        {
+            r = next() & mask;
+        } while (r >= n);
+        return r;
+    }
+};
+
+/**
+ * @brief 对 [begin, end) 中每个下标独立做概率为 p 的伯努利试验，对成功的下标调用 f
+ * @param rng 随机数引擎
+ * @param p 成功概率
+ * @param begin 起始下标
+ * @param end 结束下标（不含）
+ * @param f 调用形式为 f(i)，按下标递增的顺序调用
+ *
+ * 两次成功之间的失败次数服从几何分布，直接抽取跳过的长度，
+ * 抽取次数与成功次数成正比，与区间长度无关
+ */
+template <class F>
+void forEachBernoulli(Rng &rng, double p, int begin, int end, const F &f)
+{
+    if (p <= 0.0 || begin >= end)
+    {
+        return;
+    }
+    // p >= 1 时 log_q 为 -inf，跳过长度恒为 0
+    const double log_q = std::log1p(-std::min(p, 1.0));
+    long long i = begin;
+    while (true)
+    {
+        double skip = std::log1p(-rng.nextDouble()) / log_q;
+        if (skip >= static_cast<double>(end - i))
+        {
+            return;
+        }
+        i += static_cast<long long>(skip);
+        f(static_cast<int>(i));
+        if (++i >= end)
+        {
+            return;
+        }
+    }
+}
+
+#endif // RNG_H
@@ -0,0 +1,121 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file snapshot.h
+ * @brief 环境快照文件格式与只读文件映射
+ *
+ * 快照文件依次为：文件头、按行存放的位压缩网格（每行 wordsPerRow 个字，不含保护区域）、
+ * 按列存放的细胞数组（energies、ids、xs、ys、ages、alive）。
+ * 网格段与细胞段的起始位置按 64 字节对齐，数值按本机字节序存放，文件头记录字节序标记
+ */
+
+static const char kSnapshotMagic[8] = {'C', 'L', 'S', 'N', 'A', 'P', 0, 0}; ///< 文件标识
+static const uint32_t kSnapshotVersion = 1;                                  ///< 当前格式版本
+static const uint32_t kSnapshotByteOrder = 0x01020304u;                      ///< 字节序标记
+
+/**
+ * @struct SnapshotHeader
+ * @brief 快照文件头
+ */
+struct SnapshotHeader
+{
+    char magic[8];                ///< 文件标识 "CLSNAP"
+    uint32_t version;             ///< 格式版本
+    uint32_t byte_order;          ///< 写入时的字节序标记，读取时必须等于 kSnapshotByteOrder
+    uint32_t header_size;         ///< 文件头字节数
+    int32_t width, height;        ///< 网格尺寸
+    int32_t words_per_row;        ///< 网格每行的字数
+    uint32_t survive_mask;        ///< 存活规则掩码
+    uint32_t birth_mask;          ///< 繁殖规则掩码
+    uint32_t wrap;                ///< 边界是否环绕
+    char rule[32];                ///< B/S 规则串（为空时规则来自邻居数范围），以 0 结尾
+    int32_t next_id;              ///< 下一个新细胞的 ID
+    int32_t cell_count;           ///< 细胞数量（含能量耗尽尚未移除的细胞）
+    uint64_t seed;                ///< 随机数种子
+    uint64_t generation;          ///< 已演化的代数
+    uint64_t rng_state[4];        ///< 主随机数引擎状态
+    uint64_t grid_offset;         ///< 网格段的起始字节
+    uint64_t cells_offset;        ///< 细胞段的起始字节
+    uint64_t file_size;           ///< 文件总字节数
+};
+
+/**
+ * @struct SnapshotLayout
+ * @brief 细胞段内各数组相对 cells_offset 的位置
+ */
+struct SnapshotLayout
+{
+    uint64_t energies, ids, xs, ys, ages, alive; ///< 各数组的起始字节
+    uint64_t end;                                ///< 细胞段结束位置
+};
+
+/**
+ * @brief 计算细胞段的布局
+ * @param cell_count 细胞数量
+ * @return 各数组的相对位置，double 数组在最前面以保证 8 字节对齐
+ */
+SnapshotLayout snapshotLayout(int cell_count);
+
+/**
+ * @brief 检查文件头是否有效
+ * @param header 文件头
+ * @param file_size 实际文件字节数
+ * @param error 无效时写入原因
+ * @return 有效时返回 true
+ */
+bool checkSnapshotHeader(const SnapshotHeader &header, size_t file_size, std::string &error);
+
+/**
+ * @brief 只读取快照文件头
+ * @param path 快照路径
+ * @param header 输出的文件头
+ * @param error 失败时写入原因
+ * @return 文件头有效时返回 true
+ */
+bool readSnapshotHeader(const std::string &path, SnapshotHeader &header, std::string &error);
+
+/**
+ * @class MappedFile
+ * @brief 只读文件映射
+ *
+ * POSIX 平台用 mmap 映射整个文件，页面按需从页缓存载入；
+ * 其他平台退化为一次性读入内存
+ */
+class MappedFile
+{
+private:
+    const uint8_t *data_;        ///< 文件内容
+    size_t size_;                ///< 文件字节数
+    bool mapped_;                ///< data_ 是否来自 mmap
+    std::vector<uint8_t> buffer_; ///< 不支持 mmap 时的文件内容
+
+    MappedFile(const MappedFile &);
+    MappedFile &operator=(const MappedFile &);
+
+public:
+    MappedFile();
+    ~MappedFile();
+
+    /**
+     * @brief 打开并映射文件
+     * @param path 文件路径
+     * @return 成功时返回 true
+     */
+    bool open(const std::string &path);
+
+    /**
+     * @brief 解除映射
+     */
+    void close();
+
+    const uint8_t *data() const { return data_; }
+    size_t size() const { return size_; }
+};
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,165 @@
+#ifndef SPARSE_GRID_H
+#define SPARSE_GRID_H
+
+#include "types.h"
+#include "bit_grid.h"
+#include "step_kernel.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file sparse_grid.h
+ * @brief 稀疏分块网格声明
+ *
+ * 无边界平面上的生命游戏：平面划分为 64x64 的块，只有含活细胞的块才分配内存，
+ * 块变空后立即释放。内存与演化耗时只与活细胞占据的块数有关，与包围盒大小无关
+ */
+
+/**
+ * @class SparseGrid
+ * @brief 按块哈希存储的无边界网格
+ *
+ * 块内每行一个字，第 y 行第 x 列为 rows[y] 的第 x 位（与 BitGrid 相同的位序）。
+ * 每代只计算已有块及其边缘有活细胞一侧的相邻块，块的下一代由演化核心在 3x3 块邻域上计算。
+ * 零邻居出生的规则（B0）会使整个平面变为活细胞，不支持
+ */
+class SparseGrid
+{
+public:
+    static const int kChunkShift = 6;               ///< 块边长的对数
+    static const int kChunkSize = 1 << kChunkShift; ///< 块边长（64，恰为一个字）
+
+private:
+    /**
+     * @struct Chunk
+     * @brief 一个 64x64 的块
+     */
+    struct Chunk
+    {
+        uint64_t rows[kChunkSize]; ///< 各行的细胞
+    };
+
+    typedef std::unordered_map<uint64_t, Chunk> ChunkMap;
+
+    uint32_t survive_mask_, birth_mask_; ///< 规则掩码
+    const StepKernel *kernel_;           ///< 演化核心
+    ChunkMap chunks_;                    ///< 当前代的非空块
+    ChunkMap next_chunks_;               ///< 下一代的非空块（与 chunks_ 交替使用）
+    std::vector<uint64_t> candidates_;   ///< 本代需要计算的块（复用）
+    BitGrid scratch_;                    ///< 一个块及其四周一圈细胞（保护行与保护字存放相邻块）
+    BitGrid scratch_next_;               ///< 块的下一代
+    long long generation_;               ///< 已演化的代数
+
+    /**
+     * @brief 由块坐标生成哈希键
+     * @param cx 块列号
+     * @param cy 块行号
+     * @return 哈希键
+     */
+    static uint64_t chunkKey(int cx, int cy)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(cy)) << 32) | static_cast<uint32_t>(cx);
+    }
+    static int keyX(uint64_t key) { return static_cast<int>(static_cast<uint32_t>(key)); }
+    static int keyY(uint64_t key) { return static_cast<int>(static_cast<uint32_t>(key >> 32)); }
+
+    /**
+     * @brief 查找块
+     * @param cx 块列号
+     * @param cy 块行号
+     * @return 块指针，不存在时为空
+     */
+    const Chunk *findChunk(int cx, int cy) const;
+
+    /**
+     * @brief 计算一个块的下一代
+     * @param key 块的哈希键
+     * @param out 输出的 64 行
+     * @return 下一代块内有活细胞时返回 true
+     */
+    bool stepChunk(uint64_t key, uint64_t *out);
+
+public:
+    /**
+     * @brief 构造函数
+     * @param survive_mask 存活规则掩码
+     * @param birth_mask 繁殖规则掩码，不能包含 0 个邻居
+     */
+    SparseGrid(uint32_t survive_mask = 0x0Cu, uint32_t birth_mask = 0x08u);
+
+    /**
+     * @brief 规则是否能在无边界平面上演化
+     * @param birth_mask 繁殖规则掩码
+     * @return 零邻居不出生时返回 true
+     */
+    static bool supportsRule(uint32_t birth_mask) { return (birth_mask & 1u) == 0; }
+
+    /**
+     * @brief 放置/清除/读取细胞
+     * @param x 列号（可为负）
+     * @param y 行号（可为负）
+     *
+     * 清除后块变空时释放该块
+     */
+    void set(int x, int y);
+    void reset(int x, int y);
+    bool get(int x, int y) const;
+
+    /**
+     * @brief 清空平面
+     */
+    void clear();
+
+    /**
+     * @brief 演化若干代
+     * @param generations 代数
+     */
+    void step(int generations = 1);
+
+    /**
+     * @brief 获取已演化的代数
+     * @return 代数
+     */
+    long long getGeneration() const { return generation_; }
+
+    /**
+     * @brief 获取活细胞数
+     * @return 活细胞数，逐块统计
+     */
+    long long count() const;
+
+    /**
+     * @brief 获取已分配的块数
+     * @return 非空块数
+     */
+    int chunkCount() const { return static_cast<int>(chunks_.size()); }
+
+    /**
+     * @brief 获取活细胞的包围盒
+     * @param min_x 输出左上角列号
+     * @param min_y 输出左上角行号
+     * @param max_x 输出右下角列号（含）
+     * @param max_y 输出右下角行号（含）
+     * @return 平面为空时返回 false，不修改输出
+     */
+    bool boundingBox(int &min_x, int &min_y, int &max_x, int &max_y) const;
+
+    /**
+     * @brief 获取全部活细胞坐标
+     * @param out 输出，按行优先顺序排列
+     */
+    void getCells(std::vector<Position> &out) const;
+
+    /**
+     * @brief 读取矩形区域的细胞状态
+     * @param x0 区域左上角列号
+     * @param y0 区域左上角行号
+     * @param width 区域宽度
+     * @param height 区域高度
+     * @param out 输出，height * width 个字节，活细胞为 1
+     */
+    void getRegion(int x0, int y0, int width, int height, uint8_t *out) const;
+};
+
+#endif // SPARSE_GRID_H
@@ -0,0 +1,90 @@
+#ifndef STEP_KERNEL_H
+#define STEP_KERNEL_H
+
+#include "bit_grid.h"
+#include <cstdint>
+#include <string>
+
+/**
+ * @file step_kernel.h
+ * @brief 演化核心计算接口声明
+ *
+ * 在位压缩网格上按字并行地计算下一代状态。
+ * 提供标量、SSE2、AVX2、AVX-512 四种实现，启动时根据 CPUID 选择最快的一种；
+ * 每种实现都为常用规则生成编译期特化版本，其余规则使用运行时掩码的通用版本
+ */
+
+/**
+ * @brief 演化核心函数类型
+ * @param cur 当前网格
+ * @param next 输出网格，尺寸必须与 cur 相同
+ * @param survive_mask 存活规则掩码
+ * @param birth_mask 繁殖规则掩码
+ * @param y0 起始行
+ * @param y1 结束行（不含）
+ * @param w0 起始字
+ * @param w1 结束字（不含）
+ *
+ * 实现可能按向量宽度对齐后多计算 [w0, w1) 之外的字，
+ * 这些字同样写入正确的下一代状态
+ */
+typedef void (*StepKernelFn)(const BitGrid &cur, BitGrid &next, uint32_t survive_mask, uint32_t birth_mask,
+                             int y0, int y1, int w0, int w1);
+
+/**
+ * @struct StepKernel
+ * @brief 一种演化核心实现
+ */
+struct StepKernel
+{
+    const char *name;  ///< 实现名称（"scalar"、"sse2"、"avx2"、"avx512"）
+    const char *rule;  ///< 特化的规则（如 "B3/S23"），通用版本为 "generic"
+    StepKernelFn step; ///< 计算函数
+};
+
+/**
+ * @brief 由邻居数范围生成规则掩码
+ * @param min 邻居数下限
+ * @param max 邻居数上限
+ * @return 第 n 位表示邻居数为 n 时满足条件（n = 0..8）
+ */
+uint32_t rangeToMask(int min, int max);
+
+/**
+ * @brief 解析 B/S 规则串
+ * @param rule 规则串，如 "B3/S23"、"S23/B36"，大小写不敏感
+ * @param survive_mask 输出存活规则掩码
+ * @param birth_mask 输出繁殖规则掩码
+ * @return 格式正确时返回 true，否则不修改输出并返回 false
+ */
+bool parseRuleString(const std::string &rule, uint32_t &survive_mask, uint32_t &birth_mask);
+
+/**
+ * @brief 获取当前 CPU 支持的最快演化核心（通用规则版本）
+ * @return 演化核心，首次调用时检测 CPUID 并缓存结果
+ */
+const StepKernel &selectStepKernel();
+
+/**
+ * @brief 获取当前 CPU 支持的最快演化核心，规则有编译期特化时使用特化版本
+ * @param survive_mask 存活规则掩码
+ * @param birth_mask 繁殖规则掩码
+ * @return 演化核心
+ */
+const StepKernel &selectStepKernel(uint32_t survive_mask, uint32_t birth_mask);
+
+/**
+ * @brief 计算 [y0, y1) 行的下一代状态
+ * @param cur 当前网格
+ * @param next 输出网格，尺寸必须与 cur 相同
+ * @param survive_mask 存活规则掩码
+ * @param birth_mask 繁殖规则掩码
+ * @param y0 起始行
+ * @param y1 结束行（不含）
+ *
+ * 使用位切片加法器一次计算一个字（64 个细胞）的邻居数，
+ * 调用 selectStepKernel(survive_mask, birth_mask) 选出的实现
+ */
+void stepBitGrid(const BitGrid &cur, BitGrid &next, uint32_t survive_mask, uint32_t birth_mask, int y0, int y1);
+
+#endif // STEP_KERNEL_H
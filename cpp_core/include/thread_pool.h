@@ -0,0 +1,73 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @file thread_pool.h
+ * @brief 常驻线程池声明
+ *
+ * 工作线程在构造时创建并一直保留，每次并行调用只做一次唤醒，
+ * 避免在每一步演化中反复创建线程
+ */
+
+/**
+ * @class ThreadPool
+ * @brief 常驻线程池
+ *
+ * 调用线程本身也参与计算，因此 n 个线程的线程池只创建 n-1 个工作线程
+ */
+class ThreadPool
+{
+private:
+    std::vector<std::thread> workers_;          ///< 常驻工作线程
+    std::mutex mutex_;                          ///< 保护任务状态
+    std::condition_variable start_cv_;          ///< 通知工作线程有新任务
+    std::condition_variable done_cv_;           ///< 通知调用线程任务完成
+    const std::function<void(int)> *task_;      ///< 当前任务
+    int count_;                                 ///< 当前任务的子任务数量
+    std::atomic<int> next_;                     ///< 下一个待领取的子任务
+    int active_;                                ///< 尚未完成当前任务的工作线程数
+    unsigned long long generation_;             ///< 任务批次编号
+    bool stop_;                                 ///< 析构标记
+
+    void workerLoop();
+    void runTasks();
+
+public:
+    /**
+     * @brief 构造函数
+     * @param num_threads 参与计算的线程总数（含调用线程），小于 1 时按 1 处理
+     */
+    explicit ThreadPool(int num_threads);
+
+    /**
+     * @brief 析构函数，等待所有工作线程退出
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * @brief 获取参与计算的线程总数
+     * @return 线程数（含调用线程）
+     */
+    int size() const { return static_cast<int>(workers_.size()) + 1; }
+
+    /**
+     * @brief 并行执行 task(0) ... task(count-1)，全部完成后返回
+     * @param count 子任务数量
+     * @param task 子任务函数，参数为子任务下标
+     *
+     * 子任务按下标动态领取，不保证执行顺序；同一时间只能有一个线程调用
+     */
+    void parallelFor(int count, const std::function<void(int)> &task);
+};
+
+#endif // THREAD_POOL_H
@@ -39,4 +39,65 @@ struct Position
     }
 };
 
+/**
+ * @struct RunOptions
+ * @brief 多代连续演化的提前结束条件
+ *
+ * 与 Python 端 SmartGameEnv 判断回合结束的条件一致
+ */
+struct RunOptions
+{
+    bool stop_on_extinction; ///< 细胞全部死亡时停止
+    double saturation;       ///< 种群达到网格面积的该比例时停止，不大于 0 表示不检查
+    bool new_density;        ///< 是否逐代计算 newDensity()（逐连通块统计，开销较大）
+
+    /**
+     * @brief 构造函数
+     * @param stop_on_extinction_ 细胞全部死亡时停止，默认为 true
+     * @param saturation_ 饱和比例，默认为 0.8
+     * @param new_density_ 是否计算 newDensity()，默认为 false
+     */
+    RunOptions(bool stop_on_extinction_ = true, double saturation_ = 0.8, bool new_density_ = false)
+        : stop_on_extinction(stop_on_extinction_), saturation(saturation_), new_density(new_density_) {}
+};
+
+/**
+ * @struct StepStats
+ * @brief 最近一次演化中网格的变化量
+ */
+struct StepStats
+{
+    int births; ///< 出生的细胞数
+    int deaths; ///< 死亡的细胞数
+    int moves;  ///< 成功移动的细胞数
+
+    StepStats() : births(0), deaths(0), moves(0) {}
+};
+
+/**
+ * @struct StepRecord
+ * @brief 多代连续演化中每一代结束时的统计
+ */
+struct StepRecord
+{
+    int population;    ///< 细胞数量
+    float density;     ///< getDensity() 的值
+    float new_density; ///< newDensity() 的值（未开启时为 0）
+    int births;        ///< 本代出生的细胞数
+    int deaths;        ///< 本代死亡的细胞数
+};
+
+/**
+ * @struct ComponentInfo
+ * @brief 一个细胞连通分量（8 邻接）的统计
+ */
+struct ComponentInfo
+{
+    int cells;        ///< 分量内的活细胞数
+    int min_x, min_y; ///< 包围盒左上角
+    int max_x, max_y; ///< 包围盒右下角（含）
+
+    ComponentInfo() : cells(0), min_x(0), min_y(0), max_x(0), max_y(0) {}
+};
+
 #endif // TYPES_H
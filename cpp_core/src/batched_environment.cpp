@@ -0,0 +1,139 @@
+#include "../include/batched_environment.h"
+#include <algorithm>
+#include <thread>
+
+/**
+ * @file batched_environment.cpp
+ * @brief 批量游戏环境实现
+ */
+BatchedGameEnvironment::BatchedGameEnvironment(int num_envs, int width, int height, const std::string &config_file,
+                                               int num_threads, long long seed)
+{
+    num_envs = std::max(num_envs, 0);
+    // 并行发生在环境之间，各环境自身只用一个线程，避免线程池嵌套
+    for (int i = 0; i < num_envs; i++)
+    {
+        envs_.emplace_back(new GameEnvironment(width, height, config_file, 1, seed < 0 ? -1 : seed + i));
+    }
+    if (num_threads <= 0)
+    {
+        num_threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    num_threads = std::min(std::max(num_threads, 1), std::max(num_envs, 1));
+    if (num_threads > 1)
+    {
+        pool_.reset(new ThreadPool(num_threads));
+    }
+    order_.resize(num_envs);
+    for (int i = 0; i < num_envs; i++)
+    {
+        order_[i] = i;
+    }
+    offsets_.assign(num_envs + 1, 0);
+    moves_.resize(num_envs);
+}
+
+void BatchedGameEnvironment::forEachEnv(const std::function<void(int)> &task)
+{
+    if (pool_)
+    {
+        pool_->parallelFor(size(), [&](int k)
+                           { task(order_[k]); });
+    }
+    else
+    {
+        for (int i = 0; i < size(); i++)
+        {
+            task(i);
+        }
+    }
+}
+
+void BatchedGameEnvironment::sortByLoad()
+{
+    // 细胞数近似每个环境一步的耗时，耗时长的先领取，减少最后只剩一个线程在算的时间
+    std::stable_sort(order_.begin(), order_.end(), [this](int a, int b)
+                     { return envs_[a]->getCells().size() > envs_[b]->getCells().size(); });
+}
+
+void BatchedGameEnvironment::seed(uint64_t seed)
+{
+    for (int i = 0; i < size(); i++)
+    {
+        envs_[i]->seed(seed + static_cast<uint64_t>(i));
+    }
+}
+
+void BatchedGameEnvironment::initializeRandom(int num_cells)
+{
+    forEachEnv([&](int i)
+               { envs_[i]->initializeRandom(num_cells); });
+    sortByLoad();
+}
+
+void BatchedGameEnvironment::update()
+{
+    forEachEnv([&](int i)
+               { envs_[i]->update(); });
+    sortByLoad();
+}
+
+void BatchedGameEnvironment::updateWithMoves(const std::vector<int> &moves)
+{
+    updateWithMoves(moves.data(), static_cast<int>(moves.size()));
+}
+
+void BatchedGameEnvironment::updateWithMoves(const int *moves, int count)
+{
+    // 按当前细胞数拆分移动指令，拆分必须在任何环境更新之前完成
+    cellOffsets();
+    for (int i = 0; i < size(); i++)
+    {
+        int begin = std::min(offsets_[i], count);
+        int end = std::min(offsets_[i + 1], count);
+        moves_[i].assign(moves + begin, moves + end);
+        // 缺少指令的细胞视为不动（8），仍照常消耗能量
+        moves_[i].resize(offsets_[i + 1] - offsets_[i], 8);
+    }
+    forEachEnv([&](int i)
+               { envs_[i]->updateWithMoves(moves_[i]); });
+    sortByLoad();
+}
+
+const std::vector<int> &BatchedGameEnvironment::cellOffsets()
+{
+    offsets_[0] = 0;
+    for (int i = 0; i < size(); i++)
+    {
+        offsets_[i + 1] = offsets_[i] + envs_[i]->getCells().size();
+    }
+    return offsets_;
+}
+
+const std::vector<int> &BatchedGameEnvironment::getCellStates(float *states)
+{
+    cellOffsets();
+    const size_t obs = static_cast<size_t>(observationSize());
+    forEachEnv([&](int i)
+               { envs_[i]->getCellStates(states + static_cast<size_t>(offsets_[i]) * obs); });
+    return offsets_;
+}
+
+int BatchedGameEnvironment::observationSize() const
+{
+    if (envs_.empty())
+    {
+        return 0;
+    }
+    return envs_[0]->getObservationSize();
+}
+
+std::vector<int> BatchedGameEnvironment::getPopulations() const
+{
+    std::vector<int> populations(size());
+    for (int i = 0; i < size(); i++)
+    {
+        populations[i] = envs_[i]->getPopulation();
+    }
+    return populations;
+}
@@ -0,0 +1,52 @@
+#include "../include/bit_grid.h"
+#include <algorithm>
+
+/**
+ * @file bit_grid.cpp
+ * @brief 位压缩网格实现
+ */
+const int BitGrid::kVectorWords;
+
+BitGrid::BitGrid(int width, int height)
+    : width_(0), height_(0), words_(0), padded_(0), stride_(0)
+{
+    resize(width, height);
+}
+
+void BitGrid::resize(int width, int height)
+{
+    width_ = std::max(width, 0);
+    height_ = std::max(height, 0);
+    words_ = (width_ + 63) / 64;
+    padded_ = (words_ + kVectorWords - 1) / kVectorWords * kVectorWords;
+    // 左右各留一个保护字
+    stride_ = padded_ + 2;
+    // 上下各留一行保护行
+    data_.assign(static_cast<size_t>(height_ + 2) * stride_, 0ULL);
+}
+
+void BitGrid::clear()
+{
+    std::fill(data_.begin(), data_.end(), 0ULL);
+}
+
+int BitGrid::count() const
+{
+    // 保护区域始终为 0，直接统计全部字即可
+    int sum = 0;
+    for (uint64_t word : data_)
+    {
+        sum += popcount64(word);
+    }
+    return sum;
+}
+
+void BitGrid::swap(BitGrid &other)
+{
+    std::swap(width_, other.width_);
+    std::swap(height_, other.height_);
+    std::swap(words_, other.words_);
+    std::swap(padded_, other.padded_);
+    std::swap(stride_, other.stride_);
+    data_.swap(other.data_);
+}
@@ -2,29 +2,90 @@
 
 /**
  * @file cell.cpp
- * @brief 细胞类实现
+ * @brief 细胞存储实现
  */
-Cell::Cell(int id, Position pos)
-    : id_(id), position_(pos), alive_(true), age_(0), energy_(1.0)
+void CellStore::clear()
+{
+    // vector::clear 不释放容量，之后的出生直接复用
+    ids_.clear();
+    xs_.clear();
+    ys_.clear();
+    ages_.clear();
+    energies_.clear();
+    alive_.clear();
+}
+
+void CellStore::reserve(int capacity)
+{
+    ids_.reserve(capacity);
+    xs_.reserve(capacity);
+    ys_.reserve(capacity);
+    ages_.reserve(capacity);
+    energies_.reserve(capacity);
+    alive_.reserve(capacity);
+}
+
+void CellStore::assign(int count, const int *ids, const int *xs, const int *ys, const int *ages,
+                       const double *energies, const uint8_t *alive)
+{
+    ids_.assign(ids, ids + count);
+    xs_.assign(xs, xs + count);
+    ys_.assign(ys, ys + count);
+    ages_.assign(ages, ages + count);
+    energies_.assign(energies, energies + count);
+    alive_.assign(alive, alive + count);
+}
+
+int CellStore::push(int id, const Position &pos)
 {
     // 细胞初始化为存活状态，年龄为0，能量为1.0
+    ids_.push_back(id);
+    xs_.push_back(pos.x);
+    ys_.push_back(pos.y);
+    ages_.push_back(0);
+    energies_.push_back(1.0);
+    alive_.push_back(1);
+    return size() - 1;
+}
+
+void CellStore::swapRemove(int i)
+{
+    int last = size() - 1;
+    if (i != last)
+    {
+        ids_[i] = ids_[last];
+        xs_[i] = xs_[last];
+        ys_[i] = ys_[last];
+        ages_[i] = ages_[last];
+        energies_[i] = energies_[last];
+        alive_[i] = alive_[last];
+    }
+    ids_.pop_back();
+    xs_.pop_back();
+    ys_.pop_back();
+    ages_.pop_back();
+    energies_.pop_back();
+    alive_.pop_back();
 }
-void Cell::setAlive(bool alive)
+
+void CellStore::setAlive(int i, bool alive)
 {
-    alive_ = alive;
-    if (!alive_)
+    alive_[i] = alive ? 1 : 0;
+    if (!alive)
     {
-        energy_ = 0.0;                // 死亡细胞能量归零
-        position_ = Position(-1, -1); // 死亡细胞位置无效化
-        id_ = -1;                     // 死亡细胞ID无效化
+        energies_[i] = 0.0; // 死亡细胞能量归零
+        xs_[i] = -1;        // 死亡细胞位置无效化
+        ys_[i] = -1;
+        ids_[i] = -1; // 死亡细胞ID无效化
     }
 }
-void Cell::setEnergy(double energy)
+
+void CellStore::setEnergy(int i, double energy)
 {
-    energy_ = energy;
-    if (energy_ <= 0.0)
+    energies_[i] = energy;
+    if (energies_[i] <= 0.0)
     {
-        energy_ = 0.0;
-        alive_ = false; // 能量耗尽细胞死亡
+        energies_[i] = 0.0;
+        alive_[i] = 0; // 能量耗尽细胞死亡
     }
 }
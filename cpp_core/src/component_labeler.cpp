@@ -0,0 +1,196 @@
+#include "../include/component_labeler.h"
+#include <algorithm>
+
+/**
+ * @file component_labeler.cpp
+ * @brief 连通分量标记实现
+ */
+namespace
+{
+    int findRoot(std::vector<int> &parent, int i)
+    {
+        // 路径减半
+        while (parent[i] != i)
+        {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    }
+
+    void unite(std::vector<int> &parent, int a, int b)
+    {
+        a = findRoot(parent, a);
+        b = findRoot(parent, b);
+        // 总是让下标小的作根，根即为分量中最靠前的行段
+        if (a < b)
+        {
+            parent[b] = a;
+        }
+        else if (b < a)
+        {
+            parent[a] = b;
+        }
+    }
+
+    /**
+     * @brief 合并上下相邻两行中相互接触（含对角）的行段
+     * @param runs 行段数组
+     * @param parent 并查集
+     * @param a0 上一行行段起始下标
+     * @param a1 上一行行段结束下标（不含）
+     * @param b0 下一行行段起始下标
+     * @param b1 下一行行段结束下标（不含）
+     */
+    template <class Run>
+    void uniteRows(const Run *runs, std::vector<int> &parent, int a0, int a1, int b0, int b1)
+    {
+        int i = a0, j = b0;
+        while (i < a1 && j < b1)
+        {
+            if (runs[i].x0 <= runs[j].x1 + 1 && runs[j].x0 <= runs[i].x1 + 1)
+            {
+                unite(parent, i, j);
+            }
+            // 先结束的行段不会再接触另一行后面的行段
+            if (runs[i].x1 < runs[j].x1)
+            {
+                i++;
+            }
+            else
+            {
+                j++;
+            }
+        }
+    }
+}
+
+void ComponentLabeler::labelBand(const BitGrid &grid, int y0, int y1, Band &band)
+{
+    band.runs.clear();
+    band.parent.clear();
+    band.first_row_end = 0;
+    band.last_row_begin = 0;
+    const int words = grid.wordsPerRow();
+    int prev_begin = 0;
+
+    for (int y = y0; y < y1; y++)
+    {
+        const int row_begin = static_cast<int>(band.runs.size());
+        const uint64_t *row = grid.row(y);
+        for (int w = 0; w < words; w++)
+        {
+            uint64_t m = row[w];
+            if (!m)
+            {
+                continue;
+            }
+            // 左侧为空的活细胞是行段起点，右侧为空的活细胞是行段终点（保护字为 0）
+            uint64_t starts = m & ~((m << 1) | (row[w - 1] >> 63));
+            uint64_t ends = m & ~((m >> 1) | (row[w + 1] << 63));
+            uint64_t marks = starts | ends;
+            while (marks)
+            {
+                int bit = ctz64(marks);
+                uint64_t b = marks & (~marks + 1);
+                marks &= marks - 1;
+                int x = (w << 6) + bit;
+                if (starts & b)
+                {
+                    RowRun run = {y, x, x};
+                    band.runs.push_back(run);
+                    band.parent.push_back(static_cast<int>(band.parent.size()));
+                }
+                if (ends & b)
+                {
+                    band.runs.back().x1 = x;
+                }
+            }
+        }
+        const int row_end = static_cast<int>(band.runs.size());
+        if (y == y0)
+        {
+            band.first_row_end = row_end;
+        }
+        else
+        {
+            uniteRows(band.runs.data(), band.parent, prev_begin, row_begin, row_begin, row_end);
+        }
+        prev_begin = row_begin;
+    }
+    band.last_row_begin = prev_begin;
+}
+
+const std::vector<ComponentInfo> &ComponentLabeler::label(const BitGrid &grid, int band_rows, ThreadPool *pool)
+{
+    const int height = grid.height();
+    band_rows = std::max(band_rows, 1);
+    const int num_bands = (height + band_rows - 1) / band_rows;
+    bands_.resize(num_bands);
+
+    // 第一遍：各行带独立提取行段并合并带内相邻行
+    auto task = [&](int b)
+    {
+        labelBand(grid, b * band_rows, std::min((b + 1) * band_rows, height), bands_[b]);
+    };
+    if (pool && num_bands > 1)
+    {
+        pool->parallelFor(num_bands, task);
+    }
+    else
+    {
+        for (int b = 0; b < num_bands; b++)
+        {
+            task(b);
+        }
+    }
+
+    // 拼接各行带，局部下标加上行带偏移量
+    std::vector<int> offsets(num_bands + 1, 0);
+    for (int b = 0; b < num_bands; b++)
+    {
+        offsets[b + 1] = offsets[b] + static_cast<int>(bands_[b].runs.size());
+    }
+    runs_.resize(offsets[num_bands]);
+    parent_.resize(offsets[num_bands]);
+    for (int b = 0; b < num_bands; b++)
+    {
+        const Band &band = bands_[b];
+        std::copy(band.runs.begin(), band.runs.end(), runs_.begin() + offsets[b]);
+        for (size_t i = 0; i < band.parent.size(); i++)
+        {
+            parent_[offsets[b] + i] = band.parent[i] + offsets[b];
+        }
+    }
+
+    // 合并行带接缝：上一带的末行与下一带的首行
+    for (int b = 1; b < num_bands; b++)
+    {
+        uniteRows(runs_.data(), parent_, offsets[b - 1] + bands_[b - 1].last_row_begin, offsets[b],
+                  offsets[b], offsets[b] + bands_[b].first_row_end);
+    }
+
+    // 第二遍：按行优先顺序为每个根编号并统计
+    components_.clear();
+    label_.assign(runs_.size(), -1);
+    for (int i = 0; i < static_cast<int>(runs_.size()); i++)
+    {
+        const RowRun &run = runs_[i];
+        int root = findRoot(parent_, i);
+        if (label_[root] < 0)
+        {
+            label_[root] = static_cast<int>(components_.size());
+            ComponentInfo info;
+            info.min_x = run.x0;
+            info.max_x = run.x1;
+            info.min_y = info.max_y = run.y;
+            components_.push_back(info);
+        }
+        ComponentInfo &info = components_[label_[root]];
+        info.cells += run.x1 - run.x0 + 1;
+        info.min_x = std::min(info.min_x, run.x0);
+        info.max_x = std::max(info.max_x, run.x1);
+        info.max_y = run.y;
+    }
+    return components_;
+}
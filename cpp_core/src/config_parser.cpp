@@ -13,9 +13,11 @@ ConfigParser::ConfigParser(const std::string &config_file)
     : config_file_path_(config_file)
 {
     i_config_map = {
-        {"LIVE_MIN", 0}, {"LIVE_MAX", 1}, {"BREED_MIN", 2}, {"BREED_MAX", 3}, {"VISION", 4}, {"ENV_WIDTH", 5}, {"ENV_HEIGHT", 6}};
+        {"LIVE_MIN", 0}, {"LIVE_MAX", 1}, {"BREED_MIN", 2}, {"BREED_MAX", 3}, {"VISION", 4}, {"ENV_WIDTH", 5}, {"ENV_HEIGHT", 6}, {"THREADS", 7}, {"HASHLIFE_MAX_NODES", 8}};
     f_config_map = {
         {"DEATH_RATE", 0}, {"ENERGY_CONSUMPTION", 1}, {"RESTORE_PROB", 2}, {"RESTORE_VALUE", 3}};
+    s_config_map = {
+        {"RULE", 0}, {"KERNEL", 1}, {"BOUNDARY", 2}};
 }
 
 bool ConfigParser::loadConfig()
@@ -59,6 +61,10 @@ bool ConfigParser::loadConfig()
             {
                 f_config[f_config_map[key]] = std::stod(value);
             }
+            else if (s_config_map.find(key) != s_config_map.end())
+            {
+                s_config[s_config_map[key]] = value;
+            }
         }
     }
     return true;
@@ -147,6 +153,16 @@ bool ConfigParser::saveConfig()
                     continue;
                 }
             }
+            else if (s_config_map.find(key) != s_config_map.end())
+            {
+                size_t eqPos = currentLine.find('=');
+                if (eqPos != std::string::npos)
+                {
+                    outFile << currentLine.substr(0, eqPos + 1) << " "
+                            << s_config[s_config_map[key]] << std::endl;
+                    continue;
+                }
+            }
         }
 
         // 其他行原样写入
@@ -183,6 +199,19 @@ double ConfigParser::getDouble(const std::string &key, double default_value) con
     }
 }
 
+std::string ConfigParser::getString(const std::string &key, const std::string &default_value) const
+{
+    // 获取类型为字符串的配置值
+    if (s_config_map.find(key) != s_config_map.end())
+    {
+        return s_config[s_config_map.at(key)];
+    }
+    else
+    {
+        return default_value;
+    }
+}
+
 void ConfigParser::setInt(const std::string &key, int value)
 {
     // 设置类型为整型的配置值
@@ -201,10 +230,20 @@ void ConfigParser::setDouble(const std::string &key, double value)
     }
 }
 
+void ConfigParser::setString(const std::string &key, const std::string &value)
+{
+    // 设置类型为字符串的配置值
+    if (s_config_map.find(key) != s_config_map.end())
+    {
+        s_config[s_config_map.at(key)] = value;
+    }
+}
+
 bool ConfigParser::hasKey(const std::string &key) const
 {
     // 检查配置键值对是否存在
-    return (i_config_map.find(key) != i_config_map.end() || f_config_map.find(key) != f_config_map.end());
+    return (i_config_map.find(key) != i_config_map.end() || f_config_map.find(key) != f_config_map.end() ||
+            s_config_map.find(key) != s_config_map.end());
 }
 
 void ConfigParser::printAll() const
@@ -220,4 +259,9 @@ void ConfigParser::printAll() const
     {
         std::cout << pair.first << " = " << f_config[pair.second] << std::endl;
     }
+    std::cout << "String Configurations:" << std::endl;
+    for (const auto &pair : s_config_map)
+    {
+        std::cout << pair.first << " = " << s_config[pair.second] << std::endl;
+    }
 }
\ No newline at end of file
@@ -1,17 +1,61 @@
 #include "../include/game_environment.h"
 #include "../include/cell.h"
+#include "../include/step_kernel.h"
+#include "../include/snapshot.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <random>
-#include <queue>
-#include <utility>
 /**
  * @file game_environment.cpp
  * @brief 游戏环境实现文件
  *
  * 实现游戏环境接口，仅保留 Python 绑定中使用的方法
  */
-GameEnvironment::GameEnvironment(int width, int height, const std::string &config_file)
-    : width_(width), height_(height), config_(config_file), grid_(height, std::vector<bool>(width, false))
+const int GameEnvironment::kTileShift;
+const int GameEnvironment::kTileSize;
+const int GameEnvironment::kRngChunk;
+const int GameEnvironment::kHashLifeMinGenerations;
+const int GameEnvironment::kHashLifeProbe;
+
+namespace
+{
+    /**
+     * @brief 确定环境种子
+     * @param seed 用户给定的种子，负数表示不指定
+     * @return 64 位种子
+     */
+    uint64_t resolveSeed(long long seed)
+    {
+        if (seed >= 0)
+        {
+            return static_cast<uint64_t>(seed);
+        }
+        std::random_device rd;
+        return (static_cast<uint64_t>(rd()) << 32) ^ rd();
+    }
+
+    /**
+     * @brief 把坐标折回 [0, n)，用于环绕边界
+     * @param v 坐标，可为负或不小于 n
+     * @param n 周期
+     * @return 折回后的坐标
+     */
+    int wrapIndex(int v, int n)
+    {
+        v %= n;
+        return v < 0 ? v + n : v;
+    }
+
+    /// 试探跳跃中每代每格新建节点数超过该值时视为混沌局面（随机铺满的网格约 0.03，稳定后的残骸约 0.002）
+    const double kChaoticNodeRate = 0.01;
+}
+
+GameEnvironment::GameEnvironment(int width, int height, const std::string &config_file, int num_threads, long long seed)
+    : width_(width), height_(height), config_(config_file), grid_(width, height), next_grid_(width, height),
+      kernel_(nullptr), use_lut_(false), wrap_(false), next_id_(0), population_(0),
+      seed_(resolveSeed(seed)), generation_(0), rng_(seed_), components_valid_(false)
 {
     // 加载配置
     config_.loadConfig();
@@ -24,173 +68,792 @@ GameEnvironment::GameEnvironment(int width, int height, const std::string &confi
     Energy_consumption = config_.getDouble("ENERGY_CONSUMPTION", 0.1);
     Restore_prob = config_.getDouble("RESTORE_PROB", 0.1);
     Restore_value = config_.getDouble("RESTORE_VALUE", 0.2);
+    survive_mask_ = rangeToMask(Live_min, Live_max);
+    birth_mask_ = rangeToMask(Breed_min, Breed_max);
+    // 配置了 B/S 规则串时以规则串为准，可表示不连续的邻居数（如 B36/S23）
+    Rule = config_.getString("RULE", "");
+    if (!Rule.empty() && !parseRuleString(Rule, survive_mask_, birth_mask_))
+    {
+        std::cerr << "Invalid RULE \"" << Rule << "\", using LIVE_*/BREED_* instead" << std::endl;
+        Rule.clear();
+    }
+    // KERNEL = lut 时使用查表引擎，否则使用按 CPUID 选出的 SIMD 核心
+    use_lut_ = config_.getString("KERNEL", "") == "lut";
+    // BOUNDARY = wrap 时上下、左右边界相连（环面），否则边界外视为空
+    wrap_ = config_.getString("BOUNDARY", "") == "wrap";
+    selectKernel();
+    // 线程数：构造参数优先，其次读取配置，默认串行
+    num_threads_ = num_threads > 0 ? num_threads : config_.getInt("THREADS", 1);
+    if (num_threads_ < 1)
+    {
+        num_threads_ = 1;
+    }
+    if (num_threads_ > 1)
+    {
+        pool_.reset(new ThreadPool(num_threads_));
+    }
+    // 活跃块：初始两个缓冲区都为空，所有块都未变化
+    tiles_x_ = (std::max(width_, 0) + kTileSize - 1) >> kTileShift;
+    tiles_y_ = (std::max(height_, 0) + kTileSize - 1) >> kTileShift;
+    tile_changed_.assign(static_cast<size_t>(tiles_x_) * tiles_y_, 0);
+    tile_active_.assign(static_cast<size_t>(tiles_x_) * tiles_y_, 0);
+    cell_slot_.assign(static_cast<size_t>(std::max(width_, 0)) * std::max(height_, 0), -1);
+    move_claim_.assign(cell_slot_.size(), -1);
     // TODO:判断用户输入是否合理
 }
-const std::vector<std::shared_ptr<Cell>> &GameEnvironment::getCells() const
-{
-    // 返回活细胞列表
-    return cells_;
-}
 
-void GameEnvironment::initializeRandom(int num_cells)
+namespace
 {
-    // 先清空所有细胞
-    cells_.clear();
-    for (int i = 0; i < height_; i++)
+    // 将位压缩网格的一行展开为逐格的 0/1
+    void unpackRow(const uint64_t *row, int width, uint8_t *dst)
     {
-        for (int j = 0; j < width_; j++)
+        for (int x0 = 0; x0 < width; x0 += 64)
         {
-            grid_[i][j] = false;
+            uint64_t bits = row[x0 >> 6];
+            int n = std::min(64, width - x0);
+            // 空字直接清零
+            if (!bits)
+            {
+                std::fill(dst + x0, dst + x0 + n, 0);
+                continue;
+            }
+            for (int b = 0; b < n; b++)
+            {
+                dst[x0 + b] = static_cast<uint8_t>((bits >> b) & 1ULL);
+            }
         }
     }
-    // 随机放置细胞
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<int> distX(0, width_ - 1);
-    std::uniform_int_distribution<int> distY(0, height_ - 1);
-
-    int cells_placed = 0;
-    int attempts = 0;
-    const int max_attempts = num_cells * 10000; // 每个细胞最多尝试10000次
+}
 
-    while (cells_placed < num_cells && attempts < max_attempts)
+void GameEnvironment::parallelFor(int count, const std::function<void(int)> &task) const
+{
+    if (pool_)
     {
-        attempts++;
-
-        int x = distX(gen);
-        int y = distY(gen);
-        Position pos(x, y);
-
-        // 双重检查：先验证位置有效性，再检查是否为空
-        if (!isValidPosition(pos))
+        pool_->parallelFor(count, task);
+    }
+    else
+    {
+        for (int i = 0; i < count; i++)
         {
-            continue; // 位置无效，重试
+            task(i);
         }
+    }
+}
 
-        if (!isPositionEmpty(pos))
-        {
-            continue; // 位置已被占用，重试
-        }
+void GameEnvironment::selectKernel()
+{
+    // 常用规则使用编译期特化版本
+    kernel_ = &selectStepKernel(survive_mask_, birth_mask_);
+    if (use_lut_)
+    {
+        lut_.build(survive_mask_, birth_mask_);
+    }
+}
 
-        // 位置有效且为空，放置细胞
-        setCell(pos);
-        cells_placed++;
+bool GameEnvironment::setRule(const std::string &rule)
+{
+    if (!parseRuleString(rule, survive_mask_, birth_mask_))
+    {
+        return false;
     }
+    Rule = rule;
+    selectKernel();
+    hashlife_.reset();
+    // 按旧规则稳定的块在新规则下可能变化，下一代全部重新计算
+    std::fill(tile_changed_.begin(), tile_changed_.end(), 1);
+    return true;
 }
-void GameEnvironment::update()
+
+void GameEnvironment::gridSet(int x, int y)
 {
-    // 创建下一代状态记录
-    std::vector<std::vector<bool>> nextState(height_, std::vector<bool>(width_, false));
+    if (!grid_.get(x, y))
+    {
+        grid_.set(x, y);
+        population_++;
+        components_valid_ = false;
+    }
+    markTile(x, y);
+}
 
-    // 基于当前状态计算下一代（不立即修改）
-    for (int i = 0; i < cells_.size(); i++)
+void GameEnvironment::gridReset(int x, int y)
+{
+    if (grid_.get(x, y))
     {
-        if (cells_[i]->isAlive())
-        {
-            int x = cells_[i]->getPosition().x;
-            int y = cells_[i]->getPosition().y;
-            int liveNeighbors = 0;
+        grid_.reset(x, y);
+        population_--;
+        components_valid_ = false;
+    }
+    markTile(x, y);
+}
 
-            // 计算活邻居数量
+void GameEnvironment::computeActiveTiles()
+{
+    // 邻居数为 0 也能出生时空白块同样会变化，只能全部计算
+    if (birth_mask_ & 1u)
+    {
+        std::fill(tile_active_.begin(), tile_active_.end(), 1);
+        return;
+    }
+    // 变化块的八邻域都可能在下一代变化
+    std::fill(tile_active_.begin(), tile_active_.end(), 0);
+    for (int ty = 0; ty < tiles_y_; ty++)
+    {
+        for (int tx = 0; tx < tiles_x_; tx++)
+        {
+            if (!tile_changed_[ty * tiles_x_ + tx])
+            {
+                continue;
+            }
             for (int dy = -1; dy <= 1; dy++)
             {
                 for (int dx = -1; dx <= 1; dx++)
                 {
-                    if (dx == 0 && dy == 0)
-                        continue;
-
-                    int nx = x + dx, ny = y + dy;
-                    if (nx >= 0 && nx < width_ && ny >= 0 && ny < height_)
+                    int ny = ty + dy;
+                    int nx = tx + dx;
+                    if (wrap_)
+                    {
+                        ny = wrapIndex(ny, tiles_y_);
+                        nx = wrapIndex(nx, tiles_x_);
+                    }
+                    else if (ny < 0 || ny >= tiles_y_ || nx < 0 || nx >= tiles_x_)
                     {
-                        if (grid_[ny][nx])
-                            liveNeighbors++;
+                        continue;
                     }
+                    tile_active_[ny * tiles_x_ + nx] = 1;
                 }
             }
+        }
+    }
+}
 
-            // 应用康威规则决定下一代状态
-            if (liveNeighbors >= Live_min && liveNeighbors <= Live_max)
+void GameEnvironment::fillHalo()
+{
+    // 左右：每行第 0 列的左邻居与第 width-1 列的右邻居
+    const int last = width_ - 1;
+    for (int y = 0; y < height_; y++)
+    {
+        uint64_t *row = grid_.row(y);
+        row[-1] = ((row[last >> 6] >> (last & 63)) & 1ULL) << 63;
+        row[width_ >> 6] |= (row[0] & 1ULL) << (width_ & 63);
+    }
+    // 上下：保护行复制对侧的整行，连同左右保护一起复制，角上的邻居也随之正确
+    const int stride = grid_.stride();
+    const uint64_t *bottom = grid_.row(height_ - 1) - 1;
+    const uint64_t *top = grid_.row(0) - 1;
+    std::copy(bottom, bottom + stride, grid_.row(-1) - 1);
+    std::copy(top, top + stride, grid_.row(height_) - 1);
+}
+
+void GameEnvironment::clearHalo()
+{
+    const int words = grid_.wordsPerRow();
+    const uint64_t tail = grid_.lastWordMask();
+    for (int y = 0; y < height_; y++)
+    {
+        uint64_t *row = grid_.row(y);
+        row[-1] = 0;
+        row[words - 1] &= tail;
+        row[words] = 0;
+    }
+    const int stride = grid_.stride();
+    std::fill(grid_.row(-1) - 1, grid_.row(-1) - 1 + stride, 0ULL);
+    std::fill(grid_.row(height_) - 1, grid_.row(height_) - 1 + stride, 0ULL);
+}
+
+const CellStore &GameEnvironment::getCells() const
+{
+    // 返回活细胞列表
+    return cells_;
+}
+
+void GameEnvironment::initializeRandom(int num_cells)
+{
+    const long long area = static_cast<long long>(width_) * height_;
+    const int target = static_cast<int>(std::min<long long>(std::max(num_cells, 0), area));
+
+    // 先清空所有细胞
+    cells_.clear();
+    cells_.reserve(target);
+    std::fill(cell_slot_.begin(), cell_slot_.end(), -1);
+    next_id_ = 0;
+    grid_.clear();
+    next_grid_.clear();
+    population_ = 0;
+    components_valid_ = false;
+    last_stats_ = StepStats();
+    std::fill(tile_changed_.begin(), tile_changed_.end(), 0);
+    // 超过一半面积时抽取要留空的位置，抽取次数不超过面积的一半
+    const bool invert = target > area / 2;
+    const int picks = invert ? static_cast<int>(area - target) : target;
+    if (invert)
+    {
+        const uint64_t tail = grid_.lastWordMask();
+        for (int y = 0; y < height_; y++)
+        {
+            uint64_t *row = grid_.row(y);
+            std::fill(row, row + grid_.wordsPerRow(), ~0ULL);
+            row[grid_.wordsPerRow() - 1] = tail;
+        }
+    }
+
+    // Floyd 算法：依次从 [0, j] 中抽取 t，t 已被选中时改选 j，每次抽取恰好新增一个位置
+    for (long long j = area - picks; j < area; j++)
+    {
+        // 面积可达 2^32 以上，用 64 位的有界抽取保持均匀
+        long long t = static_cast<long long>(rng_.nextInt64(static_cast<uint64_t>(j + 1)));
+        if (grid_.get(static_cast<int>(t % width_), static_cast<int>(t / width_)) != invert)
+        {
+            t = j;
+        }
+        int x = static_cast<int>(t % width_);
+        int y = static_cast<int>(t / width_);
+        if (invert)
+        {
+            grid_.reset(x, y);
+        }
+        else
+        {
+            grid_.set(x, y);
+        }
+    }
+
+    // 按行优先顺序批量登记细胞，并标记有细胞的块
+    for (int y = 0; y < height_; y++)
+    {
+        const uint64_t *row = grid_.row(y);
+        for (int w = 0; w < grid_.wordsPerRow(); w++)
+        {
+            uint64_t bits = row[w];
+            if (bits)
             {
-                nextState[y][x] = true; // 存活
+                tile_changed_[(y >> kTileShift) * tiles_x_ + w] = 1;
             }
-            else
+            while (bits)
             {
-                nextState[y][x] = false; // 死亡
+                int bit = ctz64(bits);
+                bits &= bits - 1;
+                addCellRecord(Position((w << 6) + bit, y));
             }
         }
     }
-
-    // 处理死细胞的繁殖
-    for (int y = 0; y < height_; y++)
+    population_ = target;
+}
+void GameEnvironment::update()
+{
+    // 能量耗尽的细胞与按 Death_Rate 随机死亡的细胞本代必然死亡，其所在块必须参与计算。
+    // 随机死亡按固定长度分段，每段用几何跳跃直接抽取死亡的细胞，开销与死亡数成正比
+    const int count = cells_.size();
+    const int chunks = (count + kRngChunk - 1) / kRngChunk;
+    doomed_.clear();
+    for (int i = 0; i < count; i++)
     {
-        for (int x = 0; x < width_; x++)
+        if (!cells_.alive(i))
+        {
+            doomed_.push_back(cells_.position(i));
+        }
+    }
+    for (int c = 0; c < chunks; c++)
+    {
+        Rng rng = Rng::forStream(seed_, generation_, 2 * static_cast<uint64_t>(c) + 1);
+        forEachBernoulli(rng, Death_Rate, c * kRngChunk, std::min(count, (c + 1) * kRngChunk), [&](int i)
+                         {
+                             if (cells_.alive(i))
+                             {
+                                 doomed_.push_back(cells_.position(i));
+                             } });
+    }
+    for (const Position &pos : doomed_)
+    {
+        if (isValidPosition(pos))
         {
-            if (!grid_[y][x])
-            { // 当前是死细胞
-                int liveNeighbors = 0;
-                for (int dy = -1; dy <= 1; dy++)
+            markTile(pos.x, pos.y);
+        }
+    }
+    computeActiveTiles();
+
+    // 环绕边界下每代刷新一次保护区域，演化核心内部不做任何边界判断
+    if (wrap_)
+    {
+        fillHalo();
+    }
+
+    // 以块行（64 行）为单位并行计算下一代，只计算活跃块，连续的活跃块合并为一次调用。
+    // 未活跃块在 next_grid_ 中保存的上一代状态与当前代相同，无需计算
+    parallelFor(tiles_y_, [&](int ty)
                 {
-                    for (int dx = -1; dx <= 1; dx++)
+                    int y0 = ty << kTileShift;
+                    int y1 = std::min(y0 + kTileSize, height_);
+                    const uint8_t *active = &tile_active_[ty * tiles_x_];
+                    int tx = 0;
+                    while (tx < tiles_x_)
                     {
-                        if (dx == 0 && dy == 0)
+                        if (!active[tx])
+                        {
+                            tx++;
                             continue;
+                        }
+                        int end = tx;
+                        while (end < tiles_x_ && active[end])
+                        {
+                            end++;
+                        }
+                        if (use_lut_)
+                        {
+                            lut_.step(grid_, next_grid_, y0, y1, tx, end);
+                        }
+                        else
+                        {
+                            kernel_->step(grid_, next_grid_, survive_mask_, birth_mask_, y0, y1, tx, end);
+                        }
+                        tx = end;
+                    } });
+    if (wrap_)
+    {
+        clearHalo();
+    }
 
-                        int nx = x + dx, ny = y + dy;
-                        if (nx >= 0 && nx < width_ && ny >= 0 && ny < height_)
+    // 必然死亡的细胞仍计入邻居，但不会存活到下一代
+    for (const Position &pos : doomed_)
+    {
+        if (isValidPosition(pos))
+        {
+            next_grid_.reset(pos.x, pos.y);
+        }
+    }
+
+    // 各块行并行收集活跃块中发生变化的位，并记录每个块是否变化
+    band_births_.resize(tiles_y_);
+    band_deaths_.resize(tiles_y_);
+    parallelFor(tiles_y_, [&](int ty)
+                {
+                    std::vector<Position> &births = band_births_[ty];
+                    std::vector<Position> &deaths = band_deaths_[ty];
+                    births.clear();
+                    deaths.clear();
+                    const uint8_t *active = &tile_active_[ty * tiles_x_];
+                    uint8_t *changed = &tile_changed_[ty * tiles_x_];
+                    std::fill(changed, changed + tiles_x_, 0);
+                    int y0 = ty << kTileShift;
+                    int y1 = std::min(y0 + kTileSize, height_);
+                    for (int y = y0; y < y1; y++)
+                    {
+                        const uint64_t *cur = grid_.row(y);
+                        const uint64_t *next = next_grid_.row(y);
+                        for (int w = 0; w < tiles_x_; w++)
                         {
-                            if (grid_[ny][nx])
-                                liveNeighbors++;
+                            if (!active[w])
+                            {
+                                continue;
+                            }
+                            uint64_t diff = cur[w] ^ next[w];
+                            if (diff)
+                            {
+                                changed[w] = 1;
+                            }
+                            while (diff)
+                            {
+                                int bit = ctz64(diff);
+                                diff &= diff - 1;
+                                Position pos((w << 6) + bit, y);
+                                if ((next[w] >> bit) & 1ULL)
+                                {
+                                    births.push_back(pos);
+                                }
+                                else
+                                {
+                                    deaths.push_back(pos);
+                                }
+                            }
                         }
-                    }
-                }
+                    } });
+
+    // 交换缓冲区：未变化的块在两个缓冲区中保持一致
+    grid_.swap(next_grid_);
+    components_valid_ = false;
 
-                // 繁殖规则
-                if (liveNeighbors >= Breed_min && liveNeighbors <= Breed_max)
+    // 先应用全部死亡再按行优先顺序应用出生，结果与行带划分（线程数）无关
+    last_stats_ = StepStats();
+    for (int b = 0; b < tiles_y_; b++)
+    {
+        for (const Position &pos : band_deaths_[b])
+        {
+            removeCellRecord(pos);
+        }
+        last_stats_.deaths += static_cast<int>(band_deaths_[b].size());
+    }
+    for (int b = 0; b < tiles_y_; b++)
+    {
+        for (const Position &pos : band_births_[b])
+        {
+            addCellRecord(pos);
+        }
+        last_stats_.births += static_cast<int>(band_births_[b].size());
+    }
+    population_ += last_stats_.births - last_stats_.deaths;
+
+    // 能量和年龄更新逻辑：细胞按固定长度分段，每段使用由 (种子, 代数, 段号) 派生的独立随机数流，
+    // 结果只取决于种子，与线程数无关。恢复能量的细胞用几何跳跃抽取，不再逐个细胞抽随机数
+    const int alive_count = cells_.size();
+    const int alive_chunks = (alive_count + kRngChunk - 1) / kRngChunk;
+    parallelFor(alive_chunks, [&](int c)
                 {
-                    nextState[y][x] = true;
-                }
-            }
+                    const int begin = c * kRngChunk;
+                    const int end = std::min(alive_count, begin + kRngChunk);
+                    for (int i = begin; i < end; i++)
+                    {
+                        if (cells_.alive(i))
+                        {
+                            cells_.increaseAge(i);
+                        }
+                    }
+                    if (Restore_value != 0.0)
+                    {
+                        Rng rng = Rng::forStream(seed_, generation_, 2 * static_cast<uint64_t>(c));
+                        forEachBernoulli(rng, Restore_prob, begin, end, [&](int i)
+                                         {
+                                             if (cells_.alive(i))
+                                             {
+                                                 cells_.setEnergy(i, cells_.energy(i) + Restore_value);
+                                             } });
+                    } });
+    generation_++;
+}
+
+void GameEnvironment::seed(uint64_t seed)
+{
+    seed_ = seed;
+    generation_ = 0;
+    rng_.seed(seed);
+}
+
+bool GameEnvironment::saveSnapshot(const std::string &path) const
+{
+    static_assert(sizeof(int) == sizeof(int32_t), "snapshot stores cell arrays as int32");
+    const int words = grid_.wordsPerRow();
+    const int count = cells_.size();
+    const uint64_t grid_bytes = static_cast<uint64_t>(height_) * words * sizeof(uint64_t);
+    const SnapshotLayout layout = snapshotLayout(count);
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header.version = kSnapshotVersion;
+    header.byte_order = kSnapshotByteOrder;
+    header.header_size = sizeof(SnapshotHeader);
+    header.width = width_;
+    header.height = height_;
+    header.words_per_row = words;
+    header.survive_mask = survive_mask_;
+    header.birth_mask = birth_mask_;
+    header.wrap = wrap_ ? 1u : 0u;
+    std::strncpy(header.rule, Rule.c_str(), sizeof(header.rule) - 1);
+    header.next_id = next_id_;
+    header.cell_count = count;
+    header.seed = seed_;
+    header.generation = generation_;
+    rng_.getState(header.rng_state);
+    // 各段按 64 字节对齐，映射后可直接按字读取
+    header.grid_offset = (sizeof(SnapshotHeader) + 63) & ~static_cast<uint64_t>(63);
+    header.cells_offset = (header.grid_offset + grid_bytes + 63) & ~static_cast<uint64_t>(63);
+    header.file_size = header.cells_offset + layout.end;
+
+    std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        std::cerr << "Cannot open snapshot file " << path << std::endl;
+        return false;
+    }
+    static const char zeros[64] = {0};
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(zeros, static_cast<std::streamsize>(header.grid_offset - sizeof(header)));
+    // 网格只写每行的有效字，与 BitGrid 的行填充无关
+    for (int y = 0; y < height_; y++)
+    {
+        out.write(reinterpret_cast<const char *>(grid_.row(y)), static_cast<std::streamsize>(words * sizeof(uint64_t)));
+    }
+    out.write(zeros, static_cast<std::streamsize>(header.cells_offset - header.grid_offset - grid_bytes));
+    out.write(reinterpret_cast<const char *>(cells_.energyData()), static_cast<std::streamsize>(count * sizeof(double)));
+    out.write(reinterpret_cast<const char *>(cells_.idData()), static_cast<std::streamsize>(count * sizeof(int32_t)));
+    out.write(reinterpret_cast<const char *>(cells_.xData()), static_cast<std::streamsize>(count * sizeof(int32_t)));
+    out.write(reinterpret_cast<const char *>(cells_.yData()), static_cast<std::streamsize>(count * sizeof(int32_t)));
+    out.write(reinterpret_cast<const char *>(cells_.ageData()), static_cast<std::streamsize>(count * sizeof(int32_t)));
+    out.write(reinterpret_cast<const char *>(cells_.aliveData()), static_cast<std::streamsize>(count));
+    if (!out.flush())
+    {
+        std::cerr << "Failed to write snapshot file " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool GameEnvironment::loadSnapshot(const std::string &path)
+{
+    MappedFile file;
+    if (!file.open(path))
+    {
+        std::cerr << "Cannot open snapshot file " << path << std::endl;
+        return false;
+    }
+    SnapshotHeader header;
+    std::string error = "not a snapshot file";
+    if (file.size() < sizeof(SnapshotHeader))
+    {
+        std::cerr << "Invalid snapshot " << path << ": " << error << std::endl;
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (!checkSnapshotHeader(header, file.size(), error))
+    {
+        std::cerr << "Invalid snapshot " << path << ": " << error << std::endl;
+        return false;
+    }
+    if (header.width != width_ || header.height != height_)
+    {
+        std::cerr << "Snapshot " << path << " is " << header.width << "x" << header.height
+                  << ", environment is " << width_ << "x" << height_ << std::endl;
+        return false;
+    }
+
+    // 校验细胞与网格一致：每个细胞位于网格内的活细胞位上、位置互不重复，且每个活细胞位都有细胞。
+    // 校验通过前不修改任何状态，被拒绝的快照不影响当前环境
+    const int words = grid_.wordsPerRow();
+    const uint64_t *grid_words = reinterpret_cast<const uint64_t *>(file.data() + header.grid_offset);
+    const uint64_t tail = grid_.lastWordMask();
+    long long live = 0;
+    for (int y = 0; y < height_; y++)
+    {
+        const uint64_t *src = grid_words + static_cast<size_t>(y) * words;
+        for (int w = 0; w < words; w++)
+        {
+            live += popcount64(w == words - 1 ? src[w] & tail : src[w]);
+        }
+    }
+    const int count = header.cell_count;
+    const SnapshotLayout layout = snapshotLayout(count);
+    const uint8_t *base = file.data() + header.cells_offset;
+    const int *file_xs = reinterpret_cast<const int *>(base + layout.xs);
+    const int *file_ys = reinterpret_cast<const int *>(base + layout.ys);
+    bool consistent = live == count;
+    std::vector<uint64_t> seen(consistent ? static_cast<size_t>(height_) * words : 0, 0);
+    for (int i = 0; consistent && i < count; i++)
+    {
+        const int x = file_xs[i], y = file_ys[i];
+        if (x < 0 || x >= width_ || y < 0 || y >= height_)
+        {
+            consistent = false;
+            break;
         }
+        const size_t word = static_cast<size_t>(y) * words + (x >> 6);
+        const uint64_t bit = 1ULL << (x & 63);
+        consistent = (grid_words[word] & bit) && !(seen[word] & bit);
+        seen[word] |= bit;
+    }
+    if (!consistent)
+    {
+        std::cerr << "Invalid snapshot " << path << ": cells do not match the grid" << std::endl;
+        return false;
     }
 
-    // 同步更新所有细胞状态
+    // 网格：逐行整块拷贝，末字的越界位清零以保持核心的不变式
     for (int y = 0; y < height_; y++)
     {
-        for (int x = 0; x < width_; x++)
+        uint64_t *row = grid_.row(y);
+        std::memcpy(row, grid_words + static_cast<size_t>(y) * words, words * sizeof(uint64_t));
+        row[words - 1] &= tail;
+    }
+
+    // 细胞：先清除旧细胞的位置索引（只有细胞所在的位置非 -1），再每列一次整块拷贝并重建索引
+    for (int i = 0; i < cells_.size(); i++)
+    {
+        Position pos = cells_.position(i);
+        if (isValidPosition(pos))
+        {
+            cell_slot_[pos.y * width_ + pos.x] = -1;
+        }
+    }
+    cells_.assign(count, reinterpret_cast<const int *>(base + layout.ids), reinterpret_cast<const int *>(base + layout.xs),
+                  reinterpret_cast<const int *>(base + layout.ys), reinterpret_cast<const int *>(base + layout.ages),
+                  reinterpret_cast<const double *>(base + layout.energies), base + layout.alive);
+    for (int i = 0; i < count; i++)
+    {
+        cell_slot_[file_ys[i] * width_ + file_xs[i]] = i;
+    }
+    next_id_ = header.next_id;
+    population_ = count;
+
+    // 规则与边界
+    survive_mask_ = header.survive_mask;
+    birth_mask_ = header.birth_mask;
+    header.rule[sizeof(header.rule) - 1] = '\0';
+    Rule = header.rule;
+    wrap_ = header.wrap != 0;
+    selectKernel();
+    hashlife_.reset();
+
+    // 随机数状态
+    seed_ = header.seed;
+    generation_ = header.generation;
+    rng_.setState(header.rng_state);
+
+    // 整个网格被替换，下一代全部重新计算
+    std::fill(tile_changed_.begin(), tile_changed_.end(), 1);
+    components_valid_ = false;
+    last_stats_ = StepStats();
+    return true;
+}
+std::vector<StepRecord> GameEnvironment::run(int generations, const RunOptions &options)
+{
+    std::vector<StepRecord> records;
+    records.reserve(std::max(generations, 0));
+    const double area = static_cast<double>(width_) * height_;
+    for (int g = 0; g < generations; g++)
+    {
+        update();
+        StepRecord record;
+        record.population = getPopulation();
+        record.density = getDensity();
+        record.new_density = options.new_density ? newDensity() : 0.0f;
+        record.births = last_stats_.births;
+        record.deaths = last_stats_.deaths;
+        records.push_back(record);
+
+        if (options.stop_on_extinction && record.population == 0)
+        {
+            break;
+        }
+        if (options.saturation > 0.0 && record.population >= area * options.saturation)
+        {
+            break;
+        }
+    }
+    return records;
+}
+
+bool GameEnvironment::isPureRule() const
+{
+    // HashLife 只支持边界外为空的平面
+    if (wrap_ || Death_Rate > 0.0 || (Restore_prob > 0.0 && Restore_value != 0.0))
+    {
+        return false;
+    }
+    for (int i = 0; i < cells_.size(); i++)
+    {
+        if (!cells_.alive(i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void GameEnvironment::advance(long long generations)
+{
+    if (generations <= 0)
+    {
+        return;
+    }
+    StepStats total;
+    // 代数较少时建树与同步细胞列表的开销超过 HashLife 的收益
+    if (isPureRule() && generations >= kHashLifeMinGenerations)
+    {
+        if (!hashlife_)
         {
-            if (nextState[y][x] != grid_[y][x])
+            // 节点缓存上限，未配置时默认 200 万个节点（约 64MB）
+            int max_nodes = config_.getInt("HASHLIFE_MAX_NODES", 2000000);
+            if (max_nodes <= 0)
             {
-                if (nextState[y][x])
-                {
-                    setCell(Position{x, y});
-                }
-                else
-                {
-                    removeCell(Position{x, y});
-                }
+                max_nodes = 2000000;
             }
+            hashlife_.reset(new HashLife(survive_mask_, birth_mask_, static_cast<size_t>(max_nodes)));
         }
+        // 试探跳跃：混沌局面几乎每代都产生新节点，记忆无法复用，HashLife 反而慢于逐代演化
+        const unsigned long long created = hashlife_->createdCount();
+        advanceHashLife(kHashLifeProbe);
+        total = last_stats_;
+        generations -= kHashLifeProbe;
+        const double rate = static_cast<double>(hashlife_->createdCount() - created) /
+                            (static_cast<double>(kHashLifeProbe) * std::max(1.0, static_cast<double>(width_) * height_));
+        if (rate <= kChaoticNodeRate)
+        {
+            advanceHashLife(generations);
+            total.births += last_stats_.births;
+            total.deaths += last_stats_.deaths;
+            generations = 0;
+        }
+    }
+    for (long long g = 0; g < generations; g++)
+    {
+        update();
+        total.births += last_stats_.births;
+        total.deaths += last_stats_.deaths;
     }
+    last_stats_ = total;
+}
 
-    // 能量和年龄更新逻辑
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<double> dist(0.0, 1.0);
+void GameEnvironment::advanceHashLife(long long generations)
+{
+    if (generations <= 0)
+    {
+        last_stats_ = StepStats();
+        return;
+    }
+    // 推进前的网格存入 next_grid_，推进后与 grid_ 比较得到出生与死亡
+    next_grid_ = grid_;
+    const BitGrid &before = next_grid_;
+    hashlife_->advance(grid_, static_cast<unsigned long long>(generations));
+    generation_ += static_cast<uint64_t>(generations);
+    components_valid_ = false;
 
+    // 同步细胞列表：先删除末代不存活的细胞，剩下的细胞视为一直存活，年龄增加 generations；
+    // 其余活细胞在末代按行优先顺序出生，与 update() 中新生细胞一样年龄为 1。
+    // 出生与死亡数按首末两代的差异统计
+    last_stats_ = StepStats();
+    for (int y = 0; y < height_; y++)
+    {
+        const uint64_t *cur = grid_.row(y);
+        const uint64_t *old = before.row(y);
+        for (int w = 0; w < grid_.wordsPerRow(); w++)
+        {
+            uint64_t died = old[w] & ~cur[w];
+            while (died)
+            {
+                int bit = ctz64(died);
+                died &= died - 1;
+                removeCellRecord(Position((w << 6) + bit, y));
+                last_stats_.deaths++;
+            }
+        }
+    }
     for (int i = 0; i < cells_.size(); i++)
     {
-        if (cells_[i]->isAlive())
+        // 年龄为 int，超出范围时饱和
+        long long age = cells_.age(i) + generations;
+        cells_.increaseAge(i, static_cast<int>(std::min<long long>(age, 0x7FFFFFFF)) - cells_.age(i));
+    }
+    for (int y = 0; y < height_; y++)
+    {
+        const uint64_t *cur = grid_.row(y);
+        const uint64_t *old = before.row(y);
+        for (int w = 0; w < grid_.wordsPerRow(); w++)
         {
-            double prob = dist(gen);
-            if (prob < Restore_prob)
+            uint64_t born = cur[w] & ~old[w];
+            while (born)
             {
-                double new_energy = cells_[i]->getEnergy() + Restore_value;
-                cells_[i]->setEnergy(new_energy);
+                int bit = ctz64(born);
+                born &= born - 1;
+                addCellRecord(Position((w << 6) + bit, y));
+                cells_.increaseAge(cells_.size() - 1);
+                last_stats_.births++;
             }
-            cells_[i]->increaseAge();
         }
     }
+
+    population_ += last_stats_.births - last_stats_.deaths;
+
+    // next_grid_ 已与 grid_ 不一致，下一次 update() 需要计算全部块
+    std::fill(tile_changed_.begin(), tile_changed_.end(), 1);
 }
+
 void GameEnvironment::updateWithMoves(const std::vector<int> &moves)
 {
     // 根据移动列表更新状态（移动列表和细胞列表中的细胞一一对应）
@@ -199,181 +862,351 @@ void GameEnvironment::updateWithMoves(const std::vector<int> &moves)
     //  8 不动
     //  随move减少能量
     //  同时移入能量高的存活
-    for (int i = 0; i < moves.size(); i++)
+    static const int kMoveDx[8] = {0, 0, -1, 1, -1, 1, -1, 1};
+    static const int kMoveDy[8] = {-1, 1, 0, 0, -1, -1, 1, 1};
+    int count = std::min(static_cast<int>(moves.size()), cells_.size());
+
+    // 第一遍：每个细胞向本回合开始时为空的目标格登记，目标格只保留能量最高的细胞
+    // （能量相同时保留下标小的），其余细胞原地不动
+    claimed_targets_.clear();
+    for (int i = 0; i < count; i++)
     {
         // 若细胞能量为零，忽略移动指令
-        if (cells_[i]->getEnergy() <= 0)
+        if (cells_.energy(i) <= 0 || moves[i] < 0 || moves[i] > 7)
         {
             continue;
         }
-        Position pos = cells_[i]->getPosition();
-        switch (moves[i])
+        Position pos = cells_.position(i);
+        Position target{pos.x + kMoveDx[moves[i]], pos.y + kMoveDy[moves[i]]};
+        if (wrap_)
         {
-        case 0:
-            // 上
-            if (isValidPosition(Position{pos.x, pos.y - 1}) && isPositionEmpty(Position{pos.x, pos.y - 1}))
-            {
-                cells_[i]->setPosition(Position{pos.x, pos.y - 1});
-                grid_[pos.y][pos.x] = false;
-                grid_[pos.y - 1][pos.x] = true;
-            }
-            break;
-        case 1:
-            // 下
-            if (isValidPosition(Position{pos.x, pos.y + 1}) && isPositionEmpty(Position{pos.x, pos.y + 1}))
-            {
-                cells_[i]->setPosition(Position{pos.x, pos.y + 1});
-                grid_[pos.y][pos.x] = false;
-                grid_[pos.y + 1][pos.x] = true;
-            }
-            break;
-        case 2:
-            // 左
-            if (isValidPosition(Position{pos.x - 1, pos.y}) && isPositionEmpty(Position{pos.x - 1, pos.y}))
-            {
-                cells_[i]->setPosition(Position{pos.x - 1, pos.y});
-                grid_[pos.y][pos.x] = false;
-                grid_[pos.y][pos.x - 1] = true;
-            }
-            break;
-        case 3:
-            // 右
-            if (isValidPosition(Position{pos.x + 1, pos.y}) && isPositionEmpty(Position{pos.x + 1, pos.y}))
-            {
-                cells_[i]->setPosition(Position{pos.x + 1, pos.y});
-                grid_[pos.y][pos.x] = false;
-                grid_[pos.y][pos.x + 1] = true;
-            }
-            break;
-        case 4:
-            // 左上
-            if (isValidPosition(Position{pos.x - 1, pos.y - 1}) && isPositionEmpty(Position{pos.x - 1, pos.y - 1}))
-            {
-                cells_[i]->setPosition(Position{pos.x - 1, pos.y - 1});
-                grid_[pos.y][pos.x] = false;
-                grid_[pos.y - 1][pos.x - 1] = true;
-            }
-            break;
-        case 5:
-            // 右上
-            if (isValidPosition(Position{pos.x + 1, pos.y - 1}) && isPositionEmpty(Position{pos.x + 1, pos.y - 1}))
-            {
-                cells_[i]->setPosition(Position{pos.x + 1, pos.y - 1});
-                grid_[pos.y][pos.x] = false;
-                grid_[pos.y - 1][pos.x + 1] = true;
-            }
-            break;
-        case 6:
-            // 左下
-            if (isValidPosition(Position{pos.x - 1, pos.y + 1}) && isPositionEmpty(Position{pos.x - 1, pos.y + 1}))
-            {
-                cells_[i]->setPosition(Position{pos.x - 1, pos.y + 1});
-                grid_[pos.y][pos.x] = false;
-                grid_[pos.y + 1][pos.x - 1] = true;
-            }
-            break;
-        case 7:
-            // 右下
-            if (isValidPosition(Position{pos.x + 1, pos.y + 1}) && isPositionEmpty(Position{pos.x + 1, pos.y + 1}))
-            {
-                cells_[i]->setPosition(Position{pos.x + 1, pos.y + 1});
-                grid_[pos.y][pos.x] = false;
-                grid_[pos.y + 1][pos.x + 1] = true;
-            }
-            break;
-        case 8:
-            // 不动
-            break;
-        default:
-            break;
+            // 环绕边界：越过边界的移动从对边进入
+            target.x = wrapIndex(target.x, width_);
+            target.y = wrapIndex(target.y, height_);
+        }
+        if (!isValidPosition(target) || !isPositionEmpty(target))
+        {
+            continue;
+        }
+        int &claim = move_claim_[target.y * width_ + target.x];
+        if (claim < 0)
+        {
+            claim = i;
+            claimed_targets_.push_back(target.y * width_ + target.x);
+        }
+        else if (cells_.energy(i) > cells_.energy(claim))
+        {
+            claim = i;
+        }
+    }
+
+    // 第二遍：所有胜出的移动同时生效。目标格在本回合开始时都为空，
+    // 与任何细胞的原位置都不重合，因此应用顺序不影响结果
+    for (int target : claimed_targets_)
+    {
+        int i = move_claim_[target];
+        move_claim_[target] = -1;
+        Position pos = cells_.position(i);
+        Position to(target % width_, target / width_);
+        moveCellRecord(i, to);
+        gridReset(pos.x, pos.y);
+        gridSet(to.x, to.y);
+    }
+
+    // 减少能量：所有能量未耗尽的细胞都消耗能量，无论是否移动成功
+    for (int i = 0; i < count; i++)
+    {
+        if (cells_.energy(i) > 0)
+        {
+            cells_.setEnergy(i, cells_.energy(i) - Energy_consumption);
         }
-        // 减少能量
-        double new_energy = cells_[i]->getEnergy() - Energy_consumption;
-        cells_[i]->setEnergy(new_energy);
     }
-    // 处理同时移入
-    std::vector<Position> occupied_positions;
+    // 更新游戏状态，移动数在 update() 清零统计之后记录
+    update();
+    last_stats_.moves = static_cast<int>(claimed_targets_.size());
+}
+
+std::vector<std::vector<float>> GameEnvironment::getCellStates() const
+{
+    // 将视野范围内的细胞存活状况打包成二维数组返回
+    const int side = 2 * std::max(Vision, 0) + 1;
+    const size_t obs = static_cast<size_t>(side) * side;
+    std::vector<float> flat(static_cast<size_t>(cells_.size()) * obs);
+    getCellStates(flat.data());
+    std::vector<std::vector<float>> states(cells_.size());
     for (int i = 0; i < cells_.size(); i++)
     {
-        Position pos = cells_[i]->getPosition();
-        bool occupied = false;
-        for (int j = 0; j < occupied_positions.size(); j++)
+        states[i].assign(flat.begin() + i * obs, flat.begin() + (i + 1) * obs);
+    }
+    return states;
+}
+
+template <class Writer>
+void GameEnvironment::writeCellWindows(const Writer &write) const
+{
+    const int vision = std::max(Vision, 0);
+    const int side = 2 * vision + 1;
+    const int pw = width_ + 2 * vision;
+    const int ph = height_ + 2 * vision;
+    const int count = cells_.size();
+    if (count == 0)
+    {
+        return;
+    }
+
+    // 补白区域只在尺寸变化时清零，内部每次按当前网格重写
+    const size_t padded_size = static_cast<size_t>(pw) * ph;
+    if (obs_grid_.size() != padded_size)
+    {
+        obs_grid_.assign(padded_size, 0);
+    }
+    uint8_t *padded = obs_grid_.data();
+    parallelFor(tiles_y_, [&](int ty)
+                {
+                    int y1 = std::min((ty + 1) << kTileShift, height_);
+                    for (int y = ty << kTileShift; y < y1; y++)
+                    {
+                        unpackRow(grid_.row(y), width_, padded + static_cast<size_t>(y + vision) * pw + vision);
+                    } });
+    if (wrap_ && vision > 0)
+    {
+        // 环绕边界：左右补白列取对侧的列，上下补白行取对侧的整行（含已填好的左右补白）
+        for (int y = 0; y < height_; y++)
         {
-            if (pos.x == occupied_positions[j].x && pos.y == occupied_positions[j].y)
+            uint8_t *row = padded + static_cast<size_t>(y + vision) * pw;
+            for (int k = 0; k < vision; k++)
             {
-                occupied = true;
-                break;
+                row[k] = row[vision + wrapIndex(k - vision, width_)];
+                row[vision + width_ + k] = row[vision + wrapIndex(width_ + k, width_)];
             }
         }
-        if (!occupied)
+        for (int k = 0; k < vision; k++)
         {
-            occupied_positions.push_back(pos);
+            std::copy_n(padded + static_cast<size_t>(vision + wrapIndex(k - vision, height_)) * pw, pw,
+                        padded + static_cast<size_t>(k) * pw);
+            std::copy_n(padded + static_cast<size_t>(vision + wrapIndex(height_ + k, height_)) * pw, pw,
+                        padded + static_cast<size_t>(vision + height_ + k) * pw);
         }
-        else
-        {
-            // 找到能量最高的细胞
-            double max_energy = cells_[i]->getEnergy();
-            int max_index = i;
-            for (int k = 0; k < cells_.size(); k++)
-            {
-                if (k != i && cells_[k]->getPosition().x == pos.x && cells_[k]->getPosition().y == pos.y)
+    }
+
+    // 细胞分段并行复制视野，每段至少 256 个细胞
+    const int threads = pool_ ? pool_->size() : 1;
+    const int chunks = std::max(1, std::min(threads * 4, count / 256));
+    parallelFor(chunks, [&](int c)
                 {
-                    if (cells_[k]->getEnergy() > max_energy)
+                    int begin = static_cast<int>(static_cast<long long>(count) * c / chunks);
+                    int end = static_cast<int>(static_cast<long long>(count) * (c + 1) / chunks);
+                    std::vector<uint8_t> window;
+                    for (int i = begin; i < end; i++)
                     {
-                        max_energy = cells_[k]->getEnergy();
-                        max_index = k;
-                    }
-                }
+                        Position pos = cells_.position(i);
+                        if (!isValidPosition(pos))
+                        {
+                            // 位置已无效化的细胞逐格判断边界，与 getCellStates() 一致
+                            window.resize(static_cast<size_t>(side) * side);
+                            uint8_t *dst = window.data();
+                            for (int dy = -vision; dy <= vision; dy++)
+                            {
+                                for (int dx = -vision; dx <= vision; dx++)
+                                {
+                                    int nx = pos.x + dx;
+                                    int ny = pos.y + dy;
+                                    *dst++ = nx >= 0 && nx < width_ && ny >= 0 && ny < height_ && grid_.get(nx, ny);
+                                }
+                            }
+                            write(i, window.data(), side);
+                            continue;
+                        }
+                        // 补白网格中视野左上角恰为 (pos.x, pos.y)
+                        write(i, padded + static_cast<size_t>(pos.y) * pw + pos.x, pw);
+                    } });
+}
+
+void GameEnvironment::getCellStates(float *out) const
+{
+    const int side = 2 * std::max(Vision, 0) + 1;
+    const size_t obs = static_cast<size_t>(side) * side;
+    writeCellWindows([&](int i, const uint8_t *src, int stride)
+                     {
+                         float *dst = out + i * obs;
+                         for (int dy = 0; dy < side; dy++, src += stride, dst += side)
+                         {
+                             for (int dx = 0; dx < side; dx++)
+                             {
+                                 dst[dx] = static_cast<float>(src[dx]);
+                             }
+                         } });
+}
+
+void GameEnvironment::getCellStates(uint8_t *out) const
+{
+    const int side = 2 * std::max(Vision, 0) + 1;
+    const size_t obs = static_cast<size_t>(side) * side;
+    writeCellWindows([&](int i, const uint8_t *src, int stride)
+                     {
+                         uint8_t *dst = out + i * obs;
+                         for (int dy = 0; dy < side; dy++, src += stride, dst += side)
+                         {
+                             std::copy(src, src + side, dst);
+                         } });
+}
+
+void GameEnvironment::getPackedCellStates(uint8_t *out) const
+{
+    const int vision = std::max(Vision, 0);
+    const int side = 2 * vision + 1;
+    const size_t bytes = static_cast<size_t>(getPackedObservationSize());
+    const int count = cells_.size();
+
+    // 按位顺序追加到 64 位累加器，攒满的字节依次写出
+    struct BitWriter
+    {
+        uint8_t *dst;
+        uint64_t acc;
+        int used;
+        void put(uint64_t bits, int n)
+        {
+            acc |= bits << used;
+            used += n;
+            while (used >= 8)
+            {
+                *dst++ = static_cast<uint8_t>(acc);
+                acc >>= 8;
+                used -= 8;
             }
-            // 删除其他细胞
-            for (int k = 0; k < cells_.size(); k++)
+        }
+        void flush()
+        {
+            if (used > 0)
             {
-                if (k != max_index && cells_[k]->getPosition().x == pos.x && cells_[k]->getPosition().y == pos.y)
-                {
-                    cells_.erase(cells_.begin() + k);
-                    k--;
-                }
+                *dst++ = static_cast<uint8_t>(acc);
             }
         }
+    };
+
+    if (side > 55 || wrap_)
+    {
+        // 视野过宽时一行放不进累加器；环绕边界时视野会跨越对边，不能直接截取网格字。
+        // 这两种情况都从展开后的补白网格逐格处理
+        writeCellWindows([&](int i, const uint8_t *src, int stride)
+                         {
+                             BitWriter writer = {out + i * bytes, 0, 0};
+                             for (int dy = 0; dy < side; dy++, src += stride)
+                             {
+                                 for (int dx = 0; dx < side; dx++)
+                                 {
+                                     writer.put(src[dx], 1);
+                                 }
+                             }
+                             writer.flush(); });
+        return;
     }
-    // 更新游戏状态
-    update();
+
+    // 视野的每一行直接从位压缩网格中截取：左右保护字覆盖越界的列，
+    // 越过上下保护行的行视为空。无需展开网格
+    const uint64_t side_mask = (1ULL << side) - 1;
+    const int threads = pool_ ? pool_->size() : 1;
+    const int chunks = std::max(1, std::min(threads * 4, count / 256));
+    parallelFor(chunks, [&](int c)
+                {
+                    int begin = static_cast<int>(static_cast<long long>(count) * c / chunks);
+                    int end = static_cast<int>(static_cast<long long>(count) * (c + 1) / chunks);
+                    for (int i = begin; i < end; i++)
+                    {
+                        BitWriter writer = {out + i * bytes, 0, 0};
+                        Position pos = cells_.position(i);
+                        if (!isValidPosition(pos))
+                        {
+                            // 位置已无效化的细胞逐格判断边界，与 getCellStates() 一致
+                            for (int dy = -vision; dy <= vision; dy++)
+                            {
+                                for (int dx = -vision; dx <= vision; dx++)
+                                {
+                                    int nx = pos.x + dx;
+                                    int ny = pos.y + dy;
+                                    writer.put(nx >= 0 && nx < width_ && ny >= 0 && ny < height_ && grid_.get(nx, ny), 1);
+                                }
+                            }
+                            writer.flush();
+                            continue;
+                        }
+                        int start = pos.x - vision;
+                        int w = (start + 64) / 64 - 1; // 向下取整，start 不小于 -64
+                        int off = start - w * 64;
+                        for (int y = pos.y - vision; y <= pos.y + vision; y++)
+                        {
+                            uint64_t bits = 0;
+                            if (y >= -1 && y <= height_)
+                            {
+                                const uint64_t *row = grid_.row(y);
+                                bits = row[w] >> off;
+                                if (off + side > 64)
+                                {
+                                    bits |= row[w + 1] << (64 - off);
+                                }
+                            }
+                            writer.put(bits & side_mask, side);
+                        }
+                        writer.flush();
+                    } });
 }
 
-std::vector<std::vector<float>> GameEnvironment::getCellStates() const
+void GameEnvironment::unpackCellStates(const uint8_t *packed, int count, int obs_size, float *out)
 {
-    // 将视野范围内的细胞存活状况打包成二维数组返回
-    std::vector<std::vector<float>> states;
-    for (int i = 0; i < cells_.size(); i++)
+    // 每个字节对应 8 个浮点数，查表后整段复制
+    static const struct ByteTable
     {
-        Position pos = cells_[i]->getPosition();
-        std::vector<float> state;
-        for (int dy = -Vision; dy <= Vision; dy++)
+        float values[256][8];
+        ByteTable()
         {
-            for (int dx = -Vision; dx <= Vision; dx++)
+            for (int b = 0; b < 256; b++)
             {
-                int nx = pos.x + dx;
-                int ny = pos.y + dy;
-                if (nx >= 0 && nx < width_ && ny >= 0 && ny < height_)
+                for (int k = 0; k < 8; k++)
                 {
-                    state.push_back(grid_[ny][nx] ? 1.0f : 0.0f);
-                }
-                else
-                {
-                    state.push_back(0.0f); // 边界外视为无细胞
+                    values[b][k] = static_cast<float>((b >> k) & 1);
                 }
             }
         }
-        states.push_back(state);
+    } table;
+
+    const int full = obs_size >> 3;
+    const int rest = obs_size & 7;
+    const int bytes = (obs_size + 7) >> 3;
+    for (int i = 0; i < count; i++)
+    {
+        const uint8_t *src = packed + static_cast<size_t>(i) * bytes;
+        float *dst = out + static_cast<size_t>(i) * obs_size;
+        for (int b = 0; b < full; b++, dst += 8)
+        {
+            std::copy(table.values[src[b]], table.values[src[b]] + 8, dst);
+        }
+        if (rest)
+        {
+            std::copy(table.values[src[full]], table.values[src[full]] + rest, dst);
+        }
     }
-    return states;
 }
 
 std::vector<std::vector<bool>> GameEnvironment::getGridState() const
 {
-    // 返回网格状态
+    // 将位压缩网格展开为二维数组返回
+    std::vector<std::vector<bool>> grid(height_, std::vector<bool>(width_, false));
+    for (int y = 0; y < height_; y++)
+    {
+        for (int x = 0; x < width_; x++)
+        {
+            grid[y][x] = grid_.get(x, y);
+        }
+    }
+    return grid;
+}
 
-    return grid_;
+void GameEnvironment::getGridState(uint8_t *out) const
+{
+    for (int y = 0; y < height_; y++)
+    {
+        unpackRow(grid_.row(y), width_, out + static_cast<size_t>(y) * width_);
+    }
 }
 
 std::vector<Position> GameEnvironment::getEmptyNeighbors(const Position &pos, int d) const
@@ -389,7 +1222,7 @@ std::vector<Position> GameEnvironment::getEmptyNeighbors(const Position &pos, in
                 continue;
             }
             Position nPos{pos.x + i, pos.y + j};
-            if (!grid_[pos.y + j][pos.x + i] && pos.x + i <= width_ && pos.x + i >= 0 && pos.y + j <= height_ && pos.y + j >= 0)
+            if (isValidPosition(nPos) && !grid_.get(nPos.x, nPos.y))
             {
                 emp.push_back(nPos);
             }
@@ -401,7 +1234,7 @@ std::vector<Position> GameEnvironment::getEmptyNeighbors(const Position &pos, in
 bool GameEnvironment::isValidPosition(const Position &pos) const
 {
     // 检查位置是否合法
-    if (pos.x >= 0 && pos.x < height_ && pos.y >= 0 && pos.y < width_)
+    if (pos.x >= 0 && pos.x < width_ && pos.y >= 0 && pos.y < height_)
     {
         return true;
     }
@@ -414,7 +1247,7 @@ bool GameEnvironment::isValidPosition(const Position &pos) const
 bool GameEnvironment::isPositionEmpty(const Position &pos) const
 {
     // 检查位置是否为空
-    if (grid_[pos.y][pos.x] == false)
+    if (grid_.get(pos.x, pos.y) == false)
         return true;
     else
         return false;
@@ -422,125 +1255,60 @@ bool GameEnvironment::isPositionEmpty(const Position &pos) const
 
 int GameEnvironment::getPopulation() const
 {
-    // 获取细胞数量
-    int sum = 0;
-    for (int i = 0; i < height_; i++)
-    {
-        for (int j = 0; j < width_; j++)
-        {
-            if (grid_[i][j])
-            {
-                sum++;
-            }
-        }
-    }
-    return sum;
+    // 获取细胞数量：出生、死亡与放置时增量维护，不再扫描网格
+    return population_;
 }
 
 float GameEnvironment::getDensity() const
 {
     // 计算细胞密度
     int population = getPopulation();
-    int area = width_ * height_;
-    float density = static_cast<float>(population) / area;
+    // 面积按 64 位计算，避免大网格溢出
+    const double area = static_cast<double>(width_) * height_;
+    float density = static_cast<float>(population / area);
     return density;
 }
 
-float GameEnvironment::newDensity() const
+const std::vector<ComponentInfo> &GameEnvironment::getComponents() const
 {
-    int width = width_;
-    int height = height_;
+    if (!components_valid_)
+    {
+        // 行带与活跃块同高，各带由线程池并行标记
+        labeler_.label(grid_, kTileSize, pool_.get());
+        components_valid_ = true;
+    }
+    return labeler_.components();
+}
 
+float GameEnvironment::newDensity() const
+{
     // 如果没有活细胞，直接返回0
     if (getPopulation() == 0)
     {
         return 0.0f;
     }
 
-    // 创建访问标记矩阵，记录哪些细胞已被分组
-    std::vector<std::vector<bool>> visited(height, std::vector<bool>(width, false));
-    // 方向数组，定义8个邻居方向（包括对角线）
-    int dx[] = {-1, -1, -1, 0, 0, 1, 1, 1};
-    int dy[] = {-1, 0, 1, -1, 1, -1, 0, 1};
-
-    std::vector<float> groupDensities; // 存储每个细胞组的密度值
-
-    // 遍历整个网格
-    for (int y = 0; y < height; ++y)
+    float sum = 0.0f; // 各细胞组密度之和
+    int groups = 0;   // 细胞组数量
+    for (const ComponentInfo &info : getComponents())
     {
-        for (int x = 0; x < width; ++x)
+        // 计算当前组的边界框面积
+        long long area = static_cast<long long>(info.max_x - info.min_x + 1) * (info.max_y - info.min_y + 1);
+        if (area > 0)
         {
-            // 如果当前细胞是活的且未被访问过，则开始一个新的组
-            if (grid_[y][x] && !visited[y][x])
-            {
-                std::queue<std::pair<int, int>> q; // BFS队列
-                q.push({x, y});
-                visited[y][x] = true;
-
-                // 初始化当前组的边界框
-                int min_x = x, max_x = x, min_y = y, max_y = y;
-                int cellCount = 0; // 当前组内的活细胞数量
-
-                // BFS遍历当前组
-                while (!q.empty())
-                {
-                    auto cell = q.front();
-                    q.pop();
-                    int cx = cell.first;
-                    int cy = cell.second;
-                    cellCount++;
-
-                    // 更新边界框坐标
-                    if (cx < min_x)
-                        min_x = cx;
-                    if (cx > max_x)
-                        max_x = cx;
-                    if (cy < min_y)
-                        min_y = cy;
-                    if (cy > max_y)
-                        max_y = cy;
-
-                    // 检查8个方向的邻居
-                    for (int i = 0; i < 8; ++i)
-                    {
-                        int nx = cx + dx[i];
-                        int ny = cy + dy[i];
-                        // 确保邻居在网格范围内
-                        if (nx >= 0 && nx < width && ny >= 0 && ny < height)
-                        {
-                            if (grid_[ny][nx] && !visited[ny][nx])
-                            {
-                                visited[ny][nx] = true;
-                                q.push({nx, ny});
-                            }
-                        }
-                    }
-                }
-
-                // 计算当前组的边界框面积
-                int area = (max_x - min_x + 1) * (max_y - min_y + 1);
-                if (area > 0)
-                {
-                    float density = static_cast<float>(cellCount) / area;
-                    groupDensities.push_back(density);
-                }
-            }
+            sum += static_cast<float>(static_cast<double>(info.cells) / area);
+            groups++;
         }
     }
 
     // 计算所有组密度的平均值
-    if (groupDensities.empty())
+    if (groups == 0)
     {
         return 0.0f;
     }
-
-    float sum = 0.0f;
-    for (float d : groupDensities)
-    {
-        sum += d;
-    }
-    return sum / groupDensities.size();
+    return sum / groups;
 }
+
 void GameEnvironment::reloadConfig()
 {
     // TODO:重新加载配置
@@ -558,42 +1326,56 @@ void GameEnvironment::printConfig() const
     std::cout << "Energy_consumption: " << Energy_consumption << std::endl;
     std::cout << "Restore_prob: " << Restore_prob << std::endl;
     std::cout << "Restore_value: " << Restore_value << std::endl;
+    std::cout << "Rule: " << (Rule.empty() ? "(LIVE_*/BREED_*)" : Rule) << std::endl;
+    std::cout << "Kernel: " << getKernelName() << " " << getKernelRule() << std::endl;
 }
 void GameEnvironment::setCell(Position pos)
 {
     // 在指定位置放置细胞
-
-    if (pos.x >= 0 && pos.x < height_ && pos.y >= 0 && pos.y < width_ && !grid_[pos.y][pos.x])
+    if (isValidPosition(pos) && !grid_.get(pos.x, pos.y))
     {
-        if (cells_.size() == 0)
-        {
-            cells_.emplace_back(std::make_shared<Cell>(0, pos));
-        }
-        else
-        {
-            long long maxId = cells_[0]->getId();
-            for (int i = 0; i < cells_.size(); i++)
-            {
-                if (cells_[i]->getId() > maxId)
-                {
-                    maxId = cells_[i]->getId();
-                }
-            }
-            cells_.emplace_back(std::make_shared<Cell>(maxId + 1, pos));
-        }
-        grid_[pos.y][pos.x] = true;
+        addCellRecord(pos);
+        gridSet(pos.x, pos.y);
     }
 }
 void GameEnvironment::removeCell(Position pos)
 {
     // 移除指定位置的细胞
-    for (int i = 0; i < cells_.size(); i++)
+    if (removeCellRecord(pos))
     {
-        if (cells_[i]->getPosition().x == pos.x && cells_[i]->getPosition().y == pos.y)
-        {
-            cells_.erase(cells_.begin() + i);
-            grid_[pos.y][pos.x] = false;
-            break;
-        }
+        gridReset(pos.x, pos.y);
     }
 }
+void GameEnvironment::addCellRecord(const Position &pos)
+{
+    cell_slot_[pos.y * width_ + pos.x] = cells_.push(next_id_++, pos);
+}
+bool GameEnvironment::removeCellRecord(const Position &pos)
+{
+    if (!isValidPosition(pos))
+    {
+        return false;
+    }
+    int slot = cell_slot_[pos.y * width_ + pos.x];
+    if (slot < 0)
+    {
+        return false;
+    }
+    // 用末尾细胞填补被删除的位置
+    int last = cells_.size() - 1;
+    cells_.swapRemove(slot);
+    if (slot != last)
+    {
+        Position moved = cells_.position(slot);
+        cell_slot_[moved.y * width_ + moved.x] = slot;
+    }
+    cell_slot_[pos.y * width_ + pos.x] = -1;
+    return true;
+}
+void GameEnvironment::moveCellRecord(int i, const Position &to)
+{
+    Position from = cells_.position(i);
+    cell_slot_[from.y * width_ + from.x] = -1;
+    cell_slot_[to.y * width_ + to.x] = i;
+    cells_.setPosition(i, to);
+}
@@ -0,0 +1,486 @@
+#include "../include/hashlife.h"
+#include <algorithm>
+
+/**
+ * @file hashlife.cpp
+ * @brief HashLife 演化引擎实现
+ */
+const uint32_t HashLife::kNone;
+const uint32_t HashLife::kDead;
+const uint32_t HashLife::kAlive;
+const uint32_t HashLife::kWall;
+
+HashLife::HashLife(uint32_t survive_mask, uint32_t birth_mask, size_t max_nodes)
+    : survive_mask_(survive_mask), birth_mask_(birth_mask), max_nodes_(max_nodes), created_(0)
+{
+    reset();
+}
+
+void HashLife::setRule(uint32_t survive_mask, uint32_t birth_mask)
+{
+    // 记忆的结果依赖规则，规则变化后全部作废
+    survive_mask_ = survive_mask;
+    birth_mask_ = birth_mask;
+    reset();
+}
+
+void HashLife::reset()
+{
+    nodes_.clear();
+    slow_memo_.clear();
+    // 三种叶子节点固定位于下标 0、1、2
+    Node leaf = {0, 0, 0, 0, kNone, kNone, 0, 0, 0};
+    nodes_.push_back(leaf); // kDead
+    leaf.alive = 1;
+    leaf.bits = 1;
+    nodes_.push_back(leaf); // kAlive
+    leaf.alive = 0;
+    leaf.bits = 1u << 16;
+    nodes_.push_back(leaf); // kWall
+    wall_nodes_.assign(1, kWall);
+    dead_nodes_.assign(1, kDead);
+    buckets_.assign(1 << 16, kNone);
+}
+
+size_t HashLife::hashOf(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se) const
+{
+    uint64_t h = nw;
+    h = h * 0x9E3779B97F4A7C15ULL + ne;
+    h = h * 0x9E3779B97F4A7C15ULL + sw;
+    h = h * 0x9E3779B97F4A7C15ULL + se;
+    // 乘法只向高位扩散，桶下标取低位，需要再把高位混合回来
+    h ^= h >> 32;
+    h *= 0xD6E8FEB86659FD93ULL;
+    h ^= h >> 32;
+    return static_cast<size_t>(h);
+}
+
+void HashLife::rehash(size_t bucket_count)
+{
+    buckets_.assign(bucket_count, kNone);
+    const size_t mask = bucket_count - 1;
+    for (uint32_t i = 3; i < nodes_.size(); i++)
+    {
+        Node &node = nodes_[i];
+        size_t b = hashOf(node.nw, node.ne, node.sw, node.se) & mask;
+        node.next = buckets_[b];
+        buckets_[b] = i;
+    }
+}
+
+uint32_t HashLife::makeNode(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se)
+{
+    // 相同内容的节点只保存一份
+    size_t b = hashOf(nw, ne, sw, se) & (buckets_.size() - 1);
+    for (uint32_t i = buckets_[b]; i != kNone; i = nodes_[i].next)
+    {
+        const Node &node = nodes_[i];
+        if (node.nw == nw && node.ne == ne && node.sw == sw && node.se == se)
+        {
+            return i;
+        }
+    }
+
+    created_++;
+    Node node;
+    node.nw = nw;
+    node.ne = ne;
+    node.sw = sw;
+    node.se = se;
+    node.next = buckets_[b];
+    node.result = kNone;
+    node.level = static_cast<uint8_t>(nodes_[nw].level + 1);
+    node.alive = nodes_[nw].alive | nodes_[ne].alive | nodes_[sw].alive | nodes_[se].alive;
+    node.bits = 0;
+    if (node.level <= 2)
+    {
+        // 将四个子节点的位图拼接为边长加倍的位图
+        const int side = 1 << (node.level - 1);
+        const uint32_t quads[4] = {nw, ne, sw, se};
+        for (int q = 0; q < 4; q++)
+        {
+            uint32_t child = nodes_[quads[q]].bits;
+            int ox = (q & 1) * side, oy = (q >> 1) * side;
+            for (int y = 0; y < side; y++)
+            {
+                for (int x = 0; x < side; x++)
+                {
+                    int from = y * side + x;
+                    int to = (oy + y) * side * 2 + ox + x;
+                    node.bits |= ((child >> from) & 1u) << to;
+                    node.bits |= ((child >> (16 + from)) & 1u) << (16 + to);
+                }
+            }
+        }
+    }
+    uint32_t index = static_cast<uint32_t>(nodes_.size());
+    nodes_.push_back(node);
+    buckets_[b] = index;
+
+    if (nodes_.size() > buckets_.size())
+    {
+        rehash(buckets_.size() * 2);
+    }
+    return index;
+}
+
+uint32_t HashLife::wallNode(int level)
+{
+    while (static_cast<int>(wall_nodes_.size()) <= level)
+    {
+        uint32_t w = wall_nodes_.back();
+        wall_nodes_.push_back(makeNode(w, w, w, w));
+    }
+    return wall_nodes_[level];
+}
+
+uint32_t HashLife::deadNode(int level)
+{
+    while (static_cast<int>(dead_nodes_.size()) <= level)
+    {
+        uint32_t d = dead_nodes_.back();
+        dead_nodes_.push_back(makeNode(d, d, d, d));
+    }
+    return dead_nodes_[level];
+}
+
+uint32_t HashLife::centre(uint32_t n)
+{
+    const Node node = nodes_[n];
+    return makeNode(nodes_[node.nw].se, nodes_[node.ne].sw, nodes_[node.sw].ne, nodes_[node.se].nw);
+}
+
+uint32_t HashLife::expand(uint32_t n)
+{
+    // 将节点放在高一级节点的中心，四周用墙填充
+    const Node node = nodes_[n];
+    uint32_t w = wallNode(node.level - 1);
+    uint32_t nw = makeNode(w, w, w, node.nw);
+    uint32_t ne = makeNode(w, w, node.ne, w);
+    uint32_t sw = makeNode(w, node.sw, w, w);
+    uint32_t se = makeNode(node.se, w, w, w);
+    return makeNode(nw, ne, sw, se);
+}
+
+uint32_t HashLife::fromBits(uint32_t bits)
+{
+    // 由 4x4 位图构造 2 级节点
+    uint32_t quads[4];
+    for (int q = 0; q < 4; q++)
+    {
+        uint32_t leaves[4];
+        for (int i = 0; i < 4; i++)
+        {
+            int bit = ((q >> 1) * 2 + (i >> 1)) * 4 + (q & 1) * 2 + (i & 1);
+            leaves[i] = ((bits >> (16 + bit)) & 1u) ? kWall : (((bits >> bit) & 1u) ? kAlive : kDead);
+        }
+        quads[q] = makeNode(leaves[0], leaves[1], leaves[2], leaves[3]);
+    }
+    return makeNode(quads[0], quads[1], quads[2], quads[3]);
+}
+
+namespace
+{
+    // 计算 8x8 位图中 [lo, hi) 方形区域的下一代，区域外的位清零
+    uint64_t stepBoard(uint64_t alive, uint64_t wall, uint32_t survive_mask, uint32_t birth_mask, int lo, int hi)
+    {
+        uint64_t next = 0;
+        for (int y = lo; y < hi; y++)
+        {
+            for (int x = lo; x < hi; x++)
+            {
+                int bit = y * 8 + x;
+                if ((wall >> bit) & 1ULL)
+                {
+                    continue;
+                }
+                // 3x3 邻域去掉中心：三行分别为 111、101、111
+                uint64_t neighbours = 0x070507ULL << ((y - 1) * 8 + (x - 1));
+                int count = popcount64(alive & neighbours);
+                uint32_t mask = ((alive >> bit) & 1ULL) ? survive_mask : birth_mask;
+                next |= static_cast<uint64_t>((mask >> count) & 1u) << bit;
+            }
+        }
+        return next;
+    }
+}
+
+uint32_t HashLife::baseStep(uint32_t n, int generations)
+{
+    // 8x8 节点：拼出位图后逐代计算，得到中心 4x4 在 1 或 2 代后的状态
+    const Node node = nodes_[n];
+    const uint32_t quads[4] = {node.nw, node.ne, node.sw, node.se};
+    uint64_t alive = 0, wall = 0;
+    for (int q = 0; q < 4; q++)
+    {
+        uint32_t bits = nodes_[quads[q]].bits;
+        int ox = (q & 1) * 4, oy = (q >> 1) * 4;
+        for (int y = 0; y < 4; y++)
+        {
+            alive |= static_cast<uint64_t>((bits >> (y * 4)) & 0xFu) << ((oy + y) * 8 + ox);
+            wall |= static_cast<uint64_t>((bits >> (16 + y * 4)) & 0xFu) << ((oy + y) * 8 + ox);
+        }
+    }
+
+    if (generations == 2)
+    {
+        alive = stepBoard(alive, wall, survive_mask_, birth_mask_, 1, 7);
+    }
+    alive = stepBoard(alive, wall, survive_mask_, birth_mask_, 2, 6);
+
+    uint32_t bits = 0;
+    for (int y = 0; y < 4; y++)
+    {
+        bits |= static_cast<uint32_t>((alive >> ((y + 2) * 8 + 2)) & 0xFu) << (y * 4);
+        bits |= static_cast<uint32_t>((wall >> ((y + 2) * 8 + 2)) & 0xFu) << (16 + y * 4);
+    }
+    return fromBits(bits);
+}
+
+uint32_t HashLife::successor(uint32_t n, int j)
+{
+    const Node node = nodes_[n];
+    const int k = node.level;
+
+    // 没有活细胞且规则不允许凭空出生时，区域保持不变
+    if (!node.alive && !(birth_mask_ & 1u))
+    {
+        return centre(n);
+    }
+
+    const bool full_speed = (j == k - 2);
+    const uint64_t memo_key = (static_cast<uint64_t>(n) << 6) | static_cast<uint64_t>(j);
+    if (full_speed)
+    {
+        if (node.result != kNone)
+        {
+            return node.result;
+        }
+        if (k == 3)
+        {
+            uint32_t result = baseStep(n, 2);
+            nodes_[n].result = result;
+            return result;
+        }
+    }
+    else
+    {
+        auto it = slow_memo_.find(memo_key);
+        if (it != slow_memo_.end())
+        {
+            return it->second;
+        }
+        if (k == 3)
+        {
+            uint32_t result = baseStep(n, 1);
+            slow_memo_[memo_key] = result;
+            return result;
+        }
+    }
+
+    const Node nw = nodes_[node.nw], ne = nodes_[node.ne], sw = nodes_[node.sw], se = nodes_[node.se];
+
+    // 九个互相重叠的 k-1 级子区域
+    uint32_t sub[3][3];
+    sub[0][0] = node.nw;
+    sub[0][1] = makeNode(nw.ne, ne.nw, nw.se, ne.sw);
+    sub[0][2] = node.ne;
+    sub[1][0] = makeNode(nw.sw, nw.se, sw.nw, sw.ne);
+    sub[1][1] = makeNode(nw.se, ne.sw, sw.ne, se.nw);
+    sub[1][2] = makeNode(ne.sw, ne.se, se.nw, se.ne);
+    sub[2][0] = node.sw;
+    sub[2][1] = makeNode(sw.ne, se.nw, sw.se, se.sw);
+    sub[2][2] = node.se;
+
+    // 全速时先各推进一半时间，否则只取中心不推进时间
+    uint32_t mid[3][3];
+    for (int y = 0; y < 3; y++)
+    {
+        for (int x = 0; x < 3; x++)
+        {
+            mid[y][x] = full_speed ? successor(sub[y][x], j - 1) : centre(sub[y][x]);
+        }
+    }
+
+    // 四个 k-1 级组合区域再推进，得到中心 k-1 级结果
+    const int jj = full_speed ? j - 1 : j;
+    uint32_t r_nw = successor(makeNode(mid[0][0], mid[0][1], mid[1][0], mid[1][1]), jj);
+    uint32_t r_ne = successor(makeNode(mid[0][1], mid[0][2], mid[1][1], mid[1][2]), jj);
+    uint32_t r_sw = successor(makeNode(mid[1][0], mid[1][1], mid[2][0], mid[2][1]), jj);
+    uint32_t r_se = successor(makeNode(mid[1][1], mid[1][2], mid[2][1], mid[2][2]), jj);
+    uint32_t result = makeNode(r_nw, r_ne, r_sw, r_se);
+
+    if (full_speed)
+    {
+        nodes_[n].result = result;
+    }
+    else
+    {
+        slow_memo_[memo_key] = result;
+    }
+    return result;
+}
+
+uint32_t HashLife::build(const BitGrid &grid, int level, int x0, int y0)
+{
+    if (x0 >= grid.width() || y0 >= grid.height())
+    {
+        return wallNode(level);
+    }
+    if (level == 0)
+    {
+        return grid.get(x0, y0) ? kAlive : kDead;
+    }
+
+    const int size = 1 << level;
+    if (size >= 64 && x0 + size <= grid.width() && y0 + size <= grid.height())
+    {
+        // 完全位于网格内的大块，整块为空时直接使用全死节点
+        bool empty = true;
+        for (int y = y0; y < y0 + size && empty; y++)
+        {
+            const uint64_t *row = grid.row(y);
+            for (int w = x0 >> 6; w < (x0 + size) >> 6; w++)
+            {
+                if (row[w])
+                {
+                    empty = false;
+                    break;
+                }
+            }
+        }
+        if (empty)
+        {
+            return deadNode(level);
+        }
+    }
+
+    const int half = size >> 1;
+    uint32_t nw = build(grid, level - 1, x0, y0);
+    uint32_t ne = build(grid, level - 1, x0 + half, y0);
+    uint32_t sw = build(grid, level - 1, x0, y0 + half);
+    uint32_t se = build(grid, level - 1, x0 + half, y0 + half);
+    return makeNode(nw, ne, sw, se);
+}
+
+void HashLife::extract(uint32_t n, BitGrid &grid, int x0, int y0) const
+{
+    const Node &node = nodes_[n];
+    if (!node.alive)
+    {
+        return;
+    }
+    if (node.level == 0)
+    {
+        // 活细胞只可能出现在网格内部
+        grid.set(x0, y0);
+        return;
+    }
+    const int half = 1 << (node.level - 1);
+    extract(node.nw, grid, x0, y0);
+    extract(node.ne, grid, x0 + half, y0);
+    extract(node.sw, grid, x0, y0 + half);
+    extract(node.se, grid, x0 + half, y0 + half);
+}
+
+uint32_t HashLife::collect(uint32_t root)
+{
+    // 标记：从根节点出发可达的节点，叶子节点总是保留
+    std::vector<uint8_t> marked(nodes_.size(), 0);
+    marked[kDead] = marked[kAlive] = marked[kWall] = 1;
+    std::vector<uint32_t> stack(1, root);
+    while (!stack.empty())
+    {
+        uint32_t n = stack.back();
+        stack.pop_back();
+        if (marked[n])
+        {
+            continue;
+        }
+        marked[n] = 1;
+        const Node &node = nodes_[n];
+        stack.push_back(node.nw);
+        stack.push_back(node.ne);
+        stack.push_back(node.sw);
+        stack.push_back(node.se);
+    }
+
+    // 整理：子节点总是先于父节点创建，按原顺序压缩即可保证重映射可用
+    std::vector<uint32_t> remap(nodes_.size(), kNone);
+    std::vector<Node> kept;
+    kept.reserve(std::count(marked.begin(), marked.end(), 1));
+    for (uint32_t i = 0; i < nodes_.size(); i++)
+    {
+        if (!marked[i])
+        {
+            continue;
+        }
+        Node node = nodes_[i];
+        if (node.level > 0)
+        {
+            node.nw = remap[node.nw];
+            node.ne = remap[node.ne];
+            node.sw = remap[node.sw];
+            node.se = remap[node.se];
+        }
+        node.result = kNone; // 记忆结果可能指向已回收的节点
+        remap[i] = static_cast<uint32_t>(kept.size());
+        kept.push_back(node);
+    }
+    nodes_.swap(kept);
+
+    slow_memo_.clear();
+    wall_nodes_.assign(1, kWall);
+    dead_nodes_.assign(1, kDead);
+    size_t bucket_count = 1 << 16;
+    while (bucket_count < nodes_.size())
+    {
+        bucket_count <<= 1;
+    }
+    rehash(bucket_count);
+    return remap[root];
+}
+
+void HashLife::advance(BitGrid &grid, unsigned long long generations)
+{
+    if (generations == 0)
+    {
+        return;
+    }
+
+    // 网格放在边长 2^m 的正方形左上角，其余部分为墙
+    int m = 3;
+    while ((1 << m) < std::max(grid.width(), grid.height()))
+    {
+        m++;
+    }
+    uint32_t board = build(grid, m, 0, 0);
+
+    for (int j = 0; generations != 0; j++, generations >>= 1)
+    {
+        if (!(generations & 1ULL))
+        {
+            continue;
+        }
+        if (nodes_.size() > max_nodes_)
+        {
+            board = collect(board);
+        }
+
+        // 根节点至少为 j+2 级才能一次推进 2^j 代（递归基为 3 级）；扩展时网格始终位于中心
+        uint32_t root = board;
+        while (nodes_[root].level < std::max(m + 1, j + 2))
+        {
+            root = expand(root);
+        }
+        uint32_t result = successor(root, j);
+        while (nodes_[result].level > m)
+        {
+            result = centre(result);
+        }
+        board = result;
+    }
+
+    grid.clear();
+    extract(board, grid, 0, 0);
+}
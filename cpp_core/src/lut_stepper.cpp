@@ -0,0 +1,126 @@
+#include "../include/lut_stepper.h"
+
+/**
+ * @file lut_stepper.cpp
+ * @brief 查表演化引擎实现
+ */
+const int LutStepper::kTableSize;
+
+LutStepper::LutStepper()
+    : survive_mask_(0), birth_mask_(0)
+{
+}
+
+void LutStepper::build(uint32_t survive_mask, uint32_t birth_mask)
+{
+    if (builtFor(survive_mask, birth_mask))
+    {
+        return;
+    }
+    survive_mask_ = survive_mask;
+    birth_mask_ = birth_mask;
+    table_.assign(kTableSize, 0);
+    for (int idx = 0; idx < kTableSize; idx++)
+    {
+        uint8_t out = 0;
+        // 输出块的四个细胞位于 4x4 块的 (1,1)、(2,1)、(1,2)、(2,2)
+        for (int o = 0; o < 4; o++)
+        {
+            int cx = 1 + (o & 1);
+            int cy = 1 + (o >> 1);
+            int count = 0;
+            for (int dy = -1; dy <= 1; dy++)
+            {
+                for (int dx = -1; dx <= 1; dx++)
+                {
+                    if (dx != 0 || dy != 0)
+                    {
+                        count += (idx >> ((cy + dy) * 4 + cx + dx)) & 1;
+                    }
+                }
+            }
+            bool alive = (idx >> (cy * 4 + cx)) & 1;
+            uint32_t mask = alive ? survive_mask : birth_mask;
+            if ((mask >> count) & 1u)
+            {
+                out |= static_cast<uint8_t>(1u << o);
+            }
+        }
+        table_[idx] = out;
+    }
+}
+
+void LutStepper::step(const BitGrid &cur, BitGrid &next, int y0, int y1, int w0, int w1) const
+{
+    const uint8_t *table = table_.data();
+    const int words = cur.wordsPerRow();
+    const uint64_t tail = cur.lastWordMask();
+
+    // 每次计算两行输出，需要上下共四行输入
+    for (int y = y0; y < y1; y += 2)
+    {
+        const bool pair = y + 1 < y1;
+        const uint64_t *rows[4] = {cur.row(y - 1), cur.row(y), cur.row(y + 1), nullptr};
+        // 只剩一行输出时第四行不影响结果，用第三行代替以免越过下保护行
+        rows[3] = pair ? cur.row(y + 2) : rows[2];
+        uint64_t *out_top = next.row(y);
+        uint64_t *out_bot = pair ? next.row(y + 1) : nullptr;
+
+        for (int w = w0; w < w1; w++)
+        {
+            // s 的第 i 位为第 w*64+i-1 列，hi 的两位为第 w*64+63、w*64+64 列
+            uint64_t s[4], hi[4];
+            for (int r = 0; r < 4; r++)
+            {
+                uint64_t m = rows[r][w];
+                s[r] = (m << 1) | (rows[r][w - 1] >> 63);
+                hi[r] = (m >> 63) | ((rows[r][w + 1] & 1ULL) << 1);
+            }
+
+            // 整段为空且规则不允许零邻居出生时结果必为空，跳过查表
+            if (!table[0] && !(s[0] | s[1] | s[2] | s[3] | hi[0] | hi[1] | hi[2] | hi[3]))
+            {
+                out_top[w] = 0;
+                if (pair)
+                {
+                    out_bot[w] = 0;
+                }
+                continue;
+            }
+
+            uint64_t top = 0, bot = 0;
+            for (int k = 0; k < 31; k++)
+            {
+                int idx = static_cast<int>((s[0] & 0xF) | ((s[1] & 0xF) << 4) | ((s[2] & 0xF) << 8) | ((s[3] & 0xF) << 12));
+                uint64_t v = table[idx];
+                top |= (v & 3ULL) << (2 * k);
+                bot |= (v >> 2) << (2 * k);
+                for (int r = 0; r < 4; r++)
+                {
+                    s[r] >>= 2;
+                }
+            }
+            // 最后一对列跨越字边界：低两位来自 s，高两位来自 hi
+            int idx = 0;
+            for (int r = 0; r < 4; r++)
+            {
+                idx |= static_cast<int>((s[r] & 3ULL) | (hi[r] << 2)) << (4 * r);
+            }
+            uint64_t v = table[idx];
+            top |= (v & 3ULL) << 62;
+            bot |= (v >> 2) << 62;
+
+            // 宽度以外的位保持为 0
+            if (w == words - 1)
+            {
+                top &= tail;
+                bot &= tail;
+            }
+            out_top[w] = top;
+            if (pair)
+            {
+                out_bot[w] = bot;
+            }
+        }
+    }
+}
@@ -0,0 +1,157 @@
+#include "../include/snapshot.h"
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SMART_LIFE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @file snapshot.cpp
+ * @brief 环境快照文件格式与只读文件映射实现
+ */
+SnapshotLayout snapshotLayout(int cell_count)
+{
+    const uint64_t n = static_cast<uint64_t>(cell_count > 0 ? cell_count : 0);
+    SnapshotLayout layout;
+    layout.energies = 0;
+    layout.ids = layout.energies + n * sizeof(double);
+    layout.xs = layout.ids + n * sizeof(int32_t);
+    layout.ys = layout.xs + n * sizeof(int32_t);
+    layout.ages = layout.ys + n * sizeof(int32_t);
+    layout.alive = layout.ages + n * sizeof(int32_t);
+    layout.end = layout.alive + n;
+    return layout;
+}
+
+bool checkSnapshotHeader(const SnapshotHeader &header, size_t file_size, std::string &error)
+{
+    if (std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0)
+    {
+        error = "not a snapshot file";
+        return false;
+    }
+    if (header.version != kSnapshotVersion || header.header_size != sizeof(SnapshotHeader))
+    {
+        error = "unsupported snapshot version " + std::to_string(header.version);
+        return false;
+    }
+    if (header.byte_order != kSnapshotByteOrder)
+    {
+        error = "snapshot was written with a different byte order";
+        return false;
+    }
+    if (header.width < 0 || header.height < 0 || header.cell_count < 0 || header.words_per_row != (header.width + 63) / 64 ||
+        ((header.survive_mask | header.birth_mask) >> 9) != 0 ||
+        (header.rng_state[0] | header.rng_state[1] | header.rng_state[2] | header.rng_state[3]) == 0)
+    {
+        error = "corrupt snapshot header";
+        return false;
+    }
+    // 各段必须完整落在文件内
+    const uint64_t grid_bytes = static_cast<uint64_t>(header.height) * header.words_per_row * sizeof(uint64_t);
+    const SnapshotLayout layout = snapshotLayout(header.cell_count);
+    if (header.file_size != file_size || header.grid_offset < sizeof(SnapshotHeader) ||
+        header.grid_offset + grid_bytes > header.cells_offset || header.cells_offset + layout.end > file_size)
+    {
+        error = "truncated snapshot file";
+        return false;
+    }
+    return true;
+}
+
+bool readSnapshotHeader(const std::string &path, SnapshotHeader &header, std::string &error)
+{
+    std::ifstream in(path.c_str(), std::ios::binary | std::ios::ate);
+    if (!in)
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+    const size_t size = static_cast<size_t>(in.tellg());
+    in.seekg(0);
+    if (size < sizeof(SnapshotHeader) || !in.read(reinterpret_cast<char *>(&header), sizeof(SnapshotHeader)))
+    {
+        error = "not a snapshot file";
+        return false;
+    }
+    return checkSnapshotHeader(header, size, error);
+}
+
+MappedFile::MappedFile()
+    : data_(nullptr), size_(0), mapped_(false)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const std::string &path)
+{
+    close();
+#ifdef SMART_LIFE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    // 恢复时整个文件都会被读取，映射时一次性建立页表，避免逐页缺页
+    flags |= MAP_POPULATE;
+#endif
+    void *addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, flags, fd, 0);
+    // 映射建立后即可关闭文件描述符
+    ::close(fd);
+    if (addr == MAP_FAILED)
+    {
+        return false;
+    }
+    data_ = static_cast<const uint8_t *>(addr);
+    size_ = static_cast<size_t>(st.st_size);
+    mapped_ = true;
+    return true;
+#else
+    std::ifstream in(path.c_str(), std::ios::binary | std::ios::ate);
+    if (!in)
+    {
+        return false;
+    }
+    buffer_.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    if (buffer_.empty() || !in.read(reinterpret_cast<char *>(buffer_.data()), buffer_.size()))
+    {
+        buffer_.clear();
+        return false;
+    }
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+    return true;
+#endif
+}
+
+void MappedFile::close()
+{
+#ifdef SMART_LIFE_MMAP
+    if (mapped_)
+    {
+        munmap(const_cast<uint8_t *>(data_), size_);
+    }
+#endif
+    buffer_.clear();
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+}
@@ -0,0 +1,272 @@
+#include "../include/sparse_grid.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+/**
+ * @file sparse_grid.cpp
+ * @brief 稀疏分块网格实现
+ */
+const int SparseGrid::kChunkShift;
+const int SparseGrid::kChunkSize;
+
+SparseGrid::SparseGrid(uint32_t survive_mask, uint32_t birth_mask)
+    : survive_mask_(survive_mask), birth_mask_(birth_mask),
+      kernel_(&selectStepKernel(survive_mask, birth_mask)),
+      scratch_(kChunkSize, kChunkSize), scratch_next_(kChunkSize, kChunkSize), generation_(0)
+{
+}
+
+const SparseGrid::Chunk *SparseGrid::findChunk(int cx, int cy) const
+{
+    ChunkMap::const_iterator it = chunks_.find(chunkKey(cx, cy));
+    return it == chunks_.end() ? nullptr : &it->second;
+}
+
+void SparseGrid::set(int x, int y)
+{
+    uint64_t key = chunkKey(x >> kChunkShift, y >> kChunkShift);
+    ChunkMap::iterator it = chunks_.find(key);
+    if (it == chunks_.end())
+    {
+        Chunk chunk;
+        std::memset(chunk.rows, 0, sizeof(chunk.rows));
+        it = chunks_.insert(std::make_pair(key, chunk)).first;
+    }
+    it->second.rows[y & (kChunkSize - 1)] |= 1ULL << (x & 63);
+}
+
+void SparseGrid::reset(int x, int y)
+{
+    ChunkMap::iterator it = chunks_.find(chunkKey(x >> kChunkShift, y >> kChunkShift));
+    if (it == chunks_.end())
+    {
+        return;
+    }
+    it->second.rows[y & (kChunkSize - 1)] &= ~(1ULL << (x & 63));
+    // 块变空时释放
+    for (int r = 0; r < kChunkSize; r++)
+    {
+        if (it->second.rows[r])
+        {
+            return;
+        }
+    }
+    chunks_.erase(it);
+}
+
+bool SparseGrid::get(int x, int y) const
+{
+    const Chunk *chunk = findChunk(x >> kChunkShift, y >> kChunkShift);
+    return chunk && ((chunk->rows[y & (kChunkSize - 1)] >> (x & 63)) & 1ULL);
+}
+
+void SparseGrid::clear()
+{
+    chunks_.clear();
+    generation_ = 0;
+}
+
+bool SparseGrid::stepChunk(uint64_t key, uint64_t *out)
+{
+    const int cx = keyX(key);
+    const int cy = keyY(key);
+    // 3x3 块邻域填入 scratch_：中心块占第 0 个字，左右相邻块占保护字与第 1 个字，
+    // 上下相邻块的边缘行占保护行
+    for (int dy = -1; dy <= 1; dy++)
+    {
+        const Chunk *west = findChunk(cx - 1, cy + dy);
+        const Chunk *center = findChunk(cx, cy + dy);
+        const Chunk *east = findChunk(cx + 1, cy + dy);
+        int r0 = dy == 0 ? 0 : (dy < 0 ? kChunkSize - 1 : 0);
+        int r1 = dy == 0 ? kChunkSize : r0 + 1;
+        int y = dy == 0 ? 0 : (dy < 0 ? -1 : kChunkSize);
+        for (int r = r0; r < r1; r++, y++)
+        {
+            uint64_t *row = scratch_.row(y);
+            row[-1] = west ? west->rows[r] : 0;
+            row[0] = center ? center->rows[r] : 0;
+            row[1] = east ? east->rows[r] : 0;
+        }
+    }
+    kernel_->step(scratch_, scratch_next_, survive_mask_, birth_mask_, 0, kChunkSize, 0, 1);
+
+    uint64_t any = 0;
+    for (int r = 0; r < kChunkSize; r++)
+    {
+        out[r] = scratch_next_.row(r)[0];
+        any |= out[r];
+    }
+    return any != 0;
+}
+
+void SparseGrid::step(int generations)
+{
+    for (int g = 0; g < generations; g++)
+    {
+        // 需要计算的块：已有块，以及边缘有活细胞一侧的相邻块（只有这些块可能出生细胞）
+        candidates_.clear();
+        for (ChunkMap::const_iterator it = chunks_.begin(); it != chunks_.end(); ++it)
+        {
+            const uint64_t *rows = it->second.rows;
+            // cols 的第 0 位与第 63 位表示左右两列是否有活细胞
+            uint64_t cols = 0;
+            for (int r = 0; r < kChunkSize; r++)
+            {
+                cols |= rows[r];
+            }
+            const int cx = keyX(it->first);
+            const int cy = keyY(it->first);
+            candidates_.push_back(it->first);
+            for (int dy = -1; dy <= 1; dy++)
+            {
+                for (int dx = -1; dx <= 1; dx++)
+                {
+                    if (dx == 0 && dy == 0)
+                    {
+                        continue;
+                    }
+                    bool touch;
+                    if (dy == 0)
+                    {
+                        touch = dx < 0 ? (cols & 1ULL) != 0 : (cols >> 63) != 0;
+                    }
+                    else
+                    {
+                        uint64_t edge = rows[dy < 0 ? 0 : kChunkSize - 1];
+                        touch = dx == 0 ? edge != 0 : (dx < 0 ? (edge & 1ULL) != 0 : (edge >> 63) != 0);
+                    }
+                    if (touch && !chunks_.count(chunkKey(cx + dx, cy + dy)))
+                    {
+                        candidates_.push_back(chunkKey(cx + dx, cy + dy));
+                    }
+                }
+            }
+        }
+        std::sort(candidates_.begin(), candidates_.end());
+        candidates_.erase(std::unique(candidates_.begin(), candidates_.end()), candidates_.end());
+
+        // 只保留下一代非空的块
+        next_chunks_.clear();
+        next_chunks_.reserve(candidates_.size());
+        Chunk chunk;
+        for (uint64_t key : candidates_)
+        {
+            if (stepChunk(key, chunk.rows))
+            {
+                next_chunks_.insert(std::make_pair(key, chunk));
+            }
+        }
+        chunks_.swap(next_chunks_);
+        generation_++;
+    }
+}
+
+long long SparseGrid::count() const
+{
+    long long sum = 0;
+    for (ChunkMap::const_iterator it = chunks_.begin(); it != chunks_.end(); ++it)
+    {
+        for (int r = 0; r < kChunkSize; r++)
+        {
+            sum += popcount64(it->second.rows[r]);
+        }
+    }
+    return sum;
+}
+
+bool SparseGrid::boundingBox(int &min_x, int &min_y, int &max_x, int &max_y) const
+{
+    if (chunks_.empty())
+    {
+        return false;
+    }
+    int x0 = INT_MAX, y0 = INT_MAX, x1 = INT_MIN, y1 = INT_MIN;
+    for (ChunkMap::const_iterator it = chunks_.begin(); it != chunks_.end(); ++it)
+    {
+        const int base_x = keyX(it->first) * kChunkSize;
+        const int base_y = keyY(it->first) * kChunkSize;
+        uint64_t cols = 0;
+        for (int r = 0; r < kChunkSize; r++)
+        {
+            uint64_t m = it->second.rows[r];
+            if (m)
+            {
+                cols |= m;
+                y0 = std::min(y0, base_y + r);
+                y1 = std::max(y1, base_y + r);
+            }
+        }
+        int high = 63;
+        while (!((cols >> high) & 1ULL))
+        {
+            high--;
+        }
+        x0 = std::min(x0, base_x + ctz64(cols));
+        x1 = std::max(x1, base_x + high);
+    }
+    min_x = x0;
+    min_y = y0;
+    max_x = x1;
+    max_y = y1;
+    return true;
+}
+
+void SparseGrid::getCells(std::vector<Position> &out) const
+{
+    out.clear();
+    for (ChunkMap::const_iterator it = chunks_.begin(); it != chunks_.end(); ++it)
+    {
+        const int base_x = keyX(it->first) * kChunkSize;
+        const int base_y = keyY(it->first) * kChunkSize;
+        for (int r = 0; r < kChunkSize; r++)
+        {
+            uint64_t m = it->second.rows[r];
+            while (m)
+            {
+                int bit = ctz64(m);
+                m &= m - 1;
+                out.push_back(Position(base_x + bit, base_y + r));
+            }
+        }
+    }
+    // 块的存放顺序不确定，按行优先顺序排列后输出与哈希表无关
+    std::sort(out.begin(), out.end(), [](const Position &a, const Position &b)
+              { return a.y != b.y ? a.y < b.y : a.x < b.x; });
+}
+
+void SparseGrid::getRegion(int x0, int y0, int width, int height, uint8_t *out) const
+{
+    if (width <= 0 || height <= 0)
+    {
+        return;
+    }
+    std::memset(out, 0, static_cast<size_t>(width) * height);
+    // 只遍历与区域相交的块
+    const int cx0 = x0 >> kChunkShift, cx1 = (x0 + width - 1) >> kChunkShift;
+    const int cy0 = y0 >> kChunkShift, cy1 = (y0 + height - 1) >> kChunkShift;
+    for (int cy = cy0; cy <= cy1; cy++)
+    {
+        for (int cx = cx0; cx <= cx1; cx++)
+        {
+            const Chunk *chunk = findChunk(cx, cy);
+            if (!chunk)
+            {
+                continue;
+            }
+            const int base_x = cx * kChunkSize;
+            const int base_y = cy * kChunkSize;
+            const int ry0 = std::max(y0, base_y), ry1 = std::min(y0 + height, base_y + kChunkSize);
+            const int rx0 = std::max(x0, base_x), rx1 = std::min(x0 + width, base_x + kChunkSize);
+            for (int y = ry0; y < ry1; y++)
+            {
+                uint64_t m = chunk->rows[y - base_y];
+                uint8_t *dst = out + static_cast<size_t>(y - y0) * width;
+                for (int x = rx0; x < rx1; x++)
+                {
+                    dst[x - x0] = static_cast<uint8_t>((m >> (x - base_x)) & 1ULL);
+                }
+            }
+        }
+    }
+}
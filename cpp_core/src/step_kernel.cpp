@@ -0,0 +1,213 @@
+#include "../include/step_kernel.h"
+#include "step_kernel_isa.h"
+#include "step_kernel_impl.h"
+
+#if defined(SMART_LIFE_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+/**
+ * @file step_kernel.cpp
+ * @brief 演化核心计算实现与运行时分派
+ */
+uint32_t rangeToMask(int min, int max)
+{
+    uint32_t mask = 0;
+    for (int n = 0; n <= 8; n++)
+    {
+        if (n >= min && n <= max)
+        {
+            mask |= 1u << n;
+        }
+    }
+    return mask;
+}
+
+bool parseRuleString(const std::string &rule, uint32_t &survive_mask, uint32_t &birth_mask)
+{
+    uint32_t survive = 0, birth = 0;
+    uint32_t *target = nullptr;
+    bool seen_survive = false, seen_birth = false;
+    for (char c : rule)
+    {
+        if (c == 'B' || c == 'b')
+        {
+            if (seen_birth)
+                return false;
+            seen_birth = true;
+            target = &birth;
+        }
+        else if (c == 'S' || c == 's')
+        {
+            if (seen_survive)
+                return false;
+            seen_survive = true;
+            target = &survive;
+        }
+        else if (c >= '0' && c <= '8' && target)
+        {
+            *target |= 1u << (c - '0');
+        }
+        else if (c != '/' && c != ' ' && c != '\t')
+        {
+            return false;
+        }
+    }
+    if (!seen_survive || !seen_birth)
+    {
+        return false;
+    }
+    survive_mask = survive;
+    birth_mask = birth;
+    return true;
+}
+
+const StepRowsTable &stepRowsScalar()
+{
+    static const StepRowsTable table = makeStepRowsTable<ScalarOps>();
+    return table;
+}
+
+namespace
+{
+    // 将 BitGrid 展开为裸参数后调用指定指令集、指定规则的核心（R 为 -1 时使用通用版本）
+    template <const StepRowsTable &(*Table)(), int R>
+    void stepWith(const BitGrid &cur, BitGrid &next, uint32_t survive_mask, uint32_t birth_mask,
+                  int y0, int y1, int w0, int w1)
+    {
+        StepArgs args;
+        args.cur = cur.row(0);
+        args.next = next.row(0);
+        args.stride = cur.stride();
+        args.words = cur.wordsPerRow();
+        args.padded = cur.paddedWordsPerRow();
+        args.tail = cur.lastWordMask();
+        args.survive_mask = survive_mask;
+        args.birth_mask = birth_mask;
+        const StepRowsTable &table = Table();
+        StepRowsFn rows = R < 0 ? table.generic : table.fixed[R < 0 ? 0 : R];
+        rows(args, y0, y1, w0, w1);
+    }
+
+    /**
+     * @struct StepKernelSet
+     * @brief 一种指令集下的通用核心与全部特化核心
+     */
+    struct StepKernelSet
+    {
+        StepKernel generic;
+        StepKernel fixed[kNumFixedRules];
+    };
+
+    template <const StepRowsTable &(*Table)()>
+    StepKernelSet makeKernelSet(const char *name)
+    {
+        static_assert(kNumFixedRules == 5, "kFixedRules 变化时需同步修改此处");
+        StepKernelSet set = {{name, "generic", stepWith<Table, -1>},
+                             {{name, kFixedRules[0].name, stepWith<Table, 0>},
+                              {name, kFixedRules[1].name, stepWith<Table, 1>},
+                              {name, kFixedRules[2].name, stepWith<Table, 2>},
+                              {name, kFixedRules[3].name, stepWith<Table, 3>},
+                              {name, kFixedRules[4].name, stepWith<Table, 4>}}};
+        return set;
+    }
+
+    enum CpuLevel
+    {
+        CPU_SCALAR,
+        CPU_SSE2,
+        CPU_AVX2,
+        CPU_AVX512
+    };
+
+    // 检测 CPU 与操作系统同时支持的最高指令集
+    CpuLevel detectCpuLevel()
+    {
+#if defined(SMART_LIFE_X86) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        int max_leaf = info[0];
+        __cpuid(info, 1);
+        bool sse2 = (info[3] & (1 << 26)) != 0;
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        bool avx2 = false, avx512 = false;
+        if (osxsave && avx && max_leaf >= 7)
+        {
+            unsigned long long xcr0 = _xgetbv(0);
+            __cpuidex(info, 7, 0);
+            // XMM/YMM 状态由系统保存才能使用 AVX2，另需 opmask/ZMM 状态才能使用 AVX-512
+            avx2 = (xcr0 & 0x6) == 0x6 && (info[1] & (1 << 5)) != 0;
+            avx512 = (xcr0 & 0xE6) == 0xE6 && (info[1] & (1 << 16)) != 0;
+        }
+        if (avx512)
+            return CPU_AVX512;
+        if (avx2)
+            return CPU_AVX2;
+        if (sse2)
+            return CPU_SSE2;
+        return CPU_SCALAR;
+#elif defined(SMART_LIFE_X86)
+        // GCC/Clang 的检测同样会确认操作系统已开启对应寄存器状态
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f"))
+            return CPU_AVX512;
+        if (__builtin_cpu_supports("avx2"))
+            return CPU_AVX2;
+        if (__builtin_cpu_supports("sse2"))
+            return CPU_SSE2;
+        return CPU_SCALAR;
+#else
+        return CPU_SCALAR;
+#endif
+    }
+
+    StepKernelSet makeStepKernelSet()
+    {
+#ifdef SMART_LIFE_X86
+        switch (detectCpuLevel())
+        {
+        case CPU_AVX512:
+            return makeKernelSet<stepRowsAvx512>("avx512");
+        case CPU_AVX2:
+            return makeKernelSet<stepRowsAvx2>("avx2");
+        case CPU_SSE2:
+            return makeKernelSet<stepRowsSse2>("sse2");
+        default:
+            break;
+        }
+#endif
+        return makeKernelSet<stepRowsScalar>("scalar");
+    }
+
+    const StepKernelSet &stepKernelSet()
+    {
+        // 局部静态变量保证只检测一次且线程安全
+        static const StepKernelSet set = makeStepKernelSet();
+        return set;
+    }
+}
+
+const StepKernel &selectStepKernel()
+{
+    return stepKernelSet().generic;
+}
+
+const StepKernel &selectStepKernel(uint32_t survive_mask, uint32_t birth_mask)
+{
+    const StepKernelSet &set = stepKernelSet();
+    for (int r = 0; r < kNumFixedRules; r++)
+    {
+        if (kFixedRules[r].survive_mask == survive_mask && kFixedRules[r].birth_mask == birth_mask)
+        {
+            return set.fixed[r];
+        }
+    }
+    return set.generic;
+}
+
+void stepBitGrid(const BitGrid &cur, BitGrid &next, uint32_t survive_mask, uint32_t birth_mask, int y0, int y1)
+{
+    selectStepKernel(survive_mask, birth_mask).step(cur, next, survive_mask, birth_mask, y0, y1, 0, cur.wordsPerRow());
+}
@@ -0,0 +1,39 @@
+#include "step_kernel_isa.h"
+
+/**
+ * @file step_kernel_avx2.cpp
+ * @brief AVX2 演化核心，一次处理 256 个细胞
+ *
+ * 本文件以 AVX2 指令集选项编译，只能在 CPUID 确认支持后调用
+ */
+#ifdef SMART_LIFE_X86
+#include <immintrin.h>
+#include "step_kernel_impl.h"
+
+namespace
+{
+    struct Avx2Ops
+    {
+        typedef __m256i vec;
+        static const int lanes = 4;
+        static vec load(const uint64_t *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+        static void store(uint64_t *p, vec v) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+        static vec zero() { return _mm256_setzero_si256(); }
+        static vec ones() { return _mm256_set1_epi32(-1); }
+        static vec bitAnd(vec a, vec b) { return _mm256_and_si256(a, b); }
+        static vec bitOr(vec a, vec b) { return _mm256_or_si256(a, b); }
+        static vec bitXor(vec a, vec b) { return _mm256_xor_si256(a, b); }
+        static vec andNot(vec a, vec b) { return _mm256_andnot_si256(a, b); }
+        static vec shl1(vec a) { return _mm256_slli_epi64(a, 1); }
+        static vec shr1(vec a) { return _mm256_srli_epi64(a, 1); }
+        static vec shl63(vec a) { return _mm256_slli_epi64(a, 63); }
+        static vec shr63(vec a) { return _mm256_srli_epi64(a, 63); }
+    };
+}
+
+const StepRowsTable &stepRowsAvx2()
+{
+    static const StepRowsTable table = makeStepRowsTable<Avx2Ops>();
+    return table;
+}
+#endif
@@ -0,0 +1,39 @@
+#include "step_kernel_isa.h"
+
+/**
+ * @file step_kernel_avx512.cpp
+ * @brief AVX-512 演化核心，一次处理 512 个细胞
+ *
+ * 本文件以 AVX-512F 指令集选项编译，只能在 CPUID 确认支持后调用
+ */
+#ifdef SMART_LIFE_X86
+#include <immintrin.h>
+#include "step_kernel_impl.h"
+
+namespace
+{
+    struct Avx512Ops
+    {
+        typedef __m512i vec;
+        static const int lanes = 8;
+        static vec load(const uint64_t *p) { return _mm512_loadu_si512(p); }
+        static void store(uint64_t *p, vec v) { _mm512_storeu_si512(p, v); }
+        static vec zero() { return _mm512_setzero_si512(); }
+        static vec ones() { return _mm512_set1_epi64(-1); }
+        static vec bitAnd(vec a, vec b) { return _mm512_and_si512(a, b); }
+        static vec bitOr(vec a, vec b) { return _mm512_or_si512(a, b); }
+        static vec bitXor(vec a, vec b) { return _mm512_xor_si512(a, b); }
+        static vec andNot(vec a, vec b) { return _mm512_andnot_si512(a, b); }
+        static vec shl1(vec a) { return _mm512_slli_epi64(a, 1); }
+        static vec shr1(vec a) { return _mm512_srli_epi64(a, 1); }
+        static vec shl63(vec a) { return _mm512_slli_epi64(a, 63); }
+        static vec shr63(vec a) { return _mm512_srli_epi64(a, 63); }
+    };
+}
+
+const StepRowsTable &stepRowsAvx512()
+{
+    static const StepRowsTable table = makeStepRowsTable<Avx512Ops>();
+    return table;
+}
+#endif
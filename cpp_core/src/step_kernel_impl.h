@@ -0,0 +1,189 @@
+#ifndef STEP_KERNEL_IMPL_H
+#define STEP_KERNEL_IMPL_H
+
+#include "step_kernel_isa.h"
+
+/**
+ * @file step_kernel_impl.h
+ * @brief 演化核心的通用模板实现（仅供各指令集源文件包含）
+ *
+ * 每个指令集源文件以不同的编译选项包含本文件，并用自己的向量类型实例化模板。
+ * 所有内容放在匿名命名空间中，保证不同指令集编译出的同名实例不会在链接时互相替换；
+ * 模板只接触 StepArgs 中的裸指针，不调用任何 BitGrid 内联函数，避免其以高级指令集被实例化。
+ * 规则同样作为模板参数：常用规则的掩码是编译期常量，规则判断被完全展开且没有分支
+ */
+namespace
+{
+    /**
+     * @brief 标量“向量”，一次处理 1 个字
+     */
+    struct ScalarOps
+    {
+        typedef uint64_t vec;
+        static const int lanes = 1;
+        static vec load(const uint64_t *p) { return *p; }
+        static void store(uint64_t *p, vec v) { *p = v; }
+        static vec zero() { return 0; }
+        static vec ones() { return ~0ULL; }
+        static vec bitAnd(vec a, vec b) { return a & b; }
+        static vec bitOr(vec a, vec b) { return a | b; }
+        static vec bitXor(vec a, vec b) { return a ^ b; }
+        static vec andNot(vec a, vec b) { return ~a & b; }
+        static vec shl1(vec a) { return a << 1; }
+        static vec shr1(vec a) { return a >> 1; }
+        static vec shl63(vec a) { return a << 63; }
+        static vec shr63(vec a) { return a >> 63; }
+    };
+
+    // 半加器：s = a + b 的低位，c 为进位
+    template <class V>
+    inline void halfAdd(typename V::vec a, typename V::vec b, typename V::vec &s, typename V::vec &c)
+    {
+        s = V::bitXor(a, b);
+        c = V::bitAnd(a, b);
+    }
+
+    // 全加器：s = a + b + d 的低位，c 为进位
+    template <class V>
+    inline void fullAdd(typename V::vec a, typename V::vec b, typename V::vec d, typename V::vec &s, typename V::vec &c)
+    {
+        typename V::vec t = V::bitXor(a, b);
+        s = V::bitXor(t, d);
+        c = V::bitOr(V::bitAnd(a, b), V::bitAnd(t, d));
+    }
+
+    // 在四个位平面表示的计数中选出等于 n 的位
+    template <class V>
+    inline typename V::vec countEquals(typename V::vec b0, typename V::vec b1, typename V::vec b2, typename V::vec b3, int n)
+    {
+        typename V::vec r = V::ones();
+        r = (n & 1) ? V::bitAnd(r, b0) : V::andNot(b0, r);
+        r = (n & 2) ? V::bitAnd(r, b1) : V::andNot(b1, r);
+        r = (n & 4) ? V::bitAnd(r, b2) : V::andNot(b2, r);
+        r = (n & 8) ? V::bitAnd(r, b3) : V::andNot(b3, r);
+        return r;
+    }
+
+    // 编译期规则：掩码为常量
+    template <uint32_t Survive, uint32_t Birth>
+    struct FixedRule
+    {
+        static uint32_t survive(const StepArgs &) { return Survive; }
+        static uint32_t birth(const StepArgs &) { return Birth; }
+    };
+
+    // 运行时规则：掩码来自参数
+    struct RuntimeRule
+    {
+        static uint32_t survive(const StepArgs &args) { return args.survive_mask; }
+        static uint32_t birth(const StepArgs &args) { return args.birth_mask; }
+    };
+
+    /**
+     * @brief 计算 [y0, y1) 行的下一代状态
+     *
+     * 每次处理 V::lanes 个字：三行数据各自错位加载得到八个邻居方向，
+     * 经位切片加法器得到 4 个位平面的邻居数，再按规则掩码比较。
+     * 字区间 [w0, w1) 按向量宽度向外对齐，由于每行补齐到 8 个字，对齐后不会越过行尾
+     */
+    template <class V, class Rule>
+    void stepRows(const StepArgs &args, int y0, int y1, int w0, int w1)
+    {
+        typedef typename V::vec vec;
+        const int words = args.words;
+        const int padded = args.padded;
+        const uint64_t tail = args.tail;
+        const uint32_t survive_mask = Rule::survive(args);
+        const uint32_t birth_mask = Rule::birth(args);
+        const int wbegin = w0 / V::lanes * V::lanes;
+        const int wend = (w1 + V::lanes - 1) / V::lanes * V::lanes;
+
+        for (int y = y0; y < y1; y++)
+        {
+            const uint64_t *mid = args.cur + static_cast<ptrdiff_t>(y) * args.stride;
+            const uint64_t *up = mid - args.stride;
+            const uint64_t *down = mid + args.stride;
+            uint64_t *out = args.next + static_cast<ptrdiff_t>(y) * args.stride;
+
+            for (int w = wbegin; w < wend; w += V::lanes)
+            {
+                vec u = V::load(up + w), ul = V::load(up + w - 1), ur = V::load(up + w + 1);
+                vec m = V::load(mid + w), ml = V::load(mid + w - 1), mr = V::load(mid + w + 1);
+                vec d = V::load(down + w), dl = V::load(down + w - 1), dr = V::load(down + w + 1);
+
+                // 左邻居 (x-1) 左移一位，右邻居 (x+1) 右移一位，跨字的位由相邻字补齐
+                vec n0 = V::bitOr(V::shl1(u), V::shr63(ul));
+                vec n1 = u;
+                vec n2 = V::bitOr(V::shr1(u), V::shl63(ur));
+                vec n3 = V::bitOr(V::shl1(m), V::shr63(ml));
+                vec n4 = V::bitOr(V::shr1(m), V::shl63(mr));
+                vec n5 = V::bitOr(V::shl1(d), V::shr63(dl));
+                vec n6 = d;
+                vec n7 = V::bitOr(V::shr1(d), V::shl63(dr));
+
+                // 位切片加法器：将 8 个 1 位输入累加为 4 个位平面 b0..b3
+                vec s1, c1, s2, c2, s3, c3;
+                fullAdd<V>(n0, n1, n2, s1, c1);
+                fullAdd<V>(n3, n4, n5, s2, c2);
+                halfAdd<V>(n6, n7, s3, c3);
+
+                vec b0, c4;
+                fullAdd<V>(s1, s2, s3, b0, c4);
+
+                vec t, c5, b1, c6;
+                fullAdd<V>(c1, c2, c3, t, c5);
+                halfAdd<V>(t, c4, b1, c6);
+
+                vec b2, b3;
+                halfAdd<V>(c5, c6, b2, b3);
+
+                // 按规则掩码选出存活与繁殖的位置
+                vec survive = V::zero(), birth = V::zero();
+                for (int n = 0; n <= 8; n++)
+                {
+                    uint32_t bit = 1u << n;
+                    if ((survive_mask | birth_mask) & bit)
+                    {
+                        vec eq = countEquals<V>(b0, b1, b2, b3, n);
+                        if (survive_mask & bit)
+                            survive = V::bitOr(survive, eq);
+                        if (birth_mask & bit)
+                            birth = V::bitOr(birth, eq);
+                    }
+                }
+
+                V::store(out + w, V::bitOr(V::bitAnd(m, survive), V::andNot(m, birth)));
+            }
+
+            // 宽度以外的位与对齐填充字保持为 0
+            if (words > 0 && words - 1 >= wbegin && words - 1 < wend)
+            {
+                out[words - 1] &= tail;
+            }
+            for (int w = words > wbegin ? words : wbegin; w < wend && w < padded; w++)
+            {
+                out[w] = 0;
+            }
+        }
+    }
+
+    // 第 R 条特化规则的实现
+    template <class V, int R>
+    void stepRowsFixed(const StepArgs &args, int y0, int y1, int w0, int w1)
+    {
+        stepRows<V, FixedRule<kFixedRules[R].survive_mask, kFixedRules[R].birth_mask>>(args, y0, y1, w0, w1);
+    }
+
+    // 实例化一种指令集下的全部规则
+    template <class V>
+    StepRowsTable makeStepRowsTable()
+    {
+        static_assert(kNumFixedRules == 5, "kFixedRules 变化时需同步修改此处");
+        StepRowsTable table = {stepRows<V, RuntimeRule>,
+                               {stepRowsFixed<V, 0>, stepRowsFixed<V, 1>, stepRowsFixed<V, 2>,
+                                stepRowsFixed<V, 3>, stepRowsFixed<V, 4>}};
+        return table;
+    }
+}
+
+#endif // STEP_KERNEL_IMPL_H
@@ -0,0 +1,79 @@
+#ifndef STEP_KERNEL_ISA_H
+#define STEP_KERNEL_ISA_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file step_kernel_isa.h
+ * @brief 各指令集演化核心的内部声明
+ *
+ * 各函数分别定义在以对应指令集选项编译的源文件中，
+ * 只能在 CPUID 确认支持后调用
+ */
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SMART_LIFE_X86 1
+#endif
+
+/**
+ * @struct StepArgs
+ * @brief 演化核心的裸参数
+ *
+ * 由 BitGrid 在普通编译选项的源文件中展开，指令集源文件只接触这些裸指针
+ */
+struct StepArgs
+{
+    const uint64_t *cur;   ///< 当前网格第 0 行首个有效字
+    uint64_t *next;        ///< 输出网格第 0 行首个有效字
+    int stride;            ///< 行跨度（字）
+    int words;             ///< 每行覆盖宽度所需的字数
+    int padded;            ///< 每行补齐后的字数
+    uint64_t tail;         ///< 最后一个有效字的掩码
+    uint32_t survive_mask; ///< 存活规则掩码
+    uint32_t birth_mask;   ///< 繁殖规则掩码
+};
+
+/**
+ * @struct FixedRuleSpec
+ * @brief 编译期特化的规则
+ */
+struct FixedRuleSpec
+{
+    const char *name;      ///< B/S 规则串
+    uint32_t survive_mask; ///< 存活规则掩码
+    uint32_t birth_mask;   ///< 繁殖规则掩码
+};
+
+static const int kNumFixedRules = 5; ///< 编译期特化的规则数量
+
+/// 编译期特化的常用规则，其余规则使用运行时掩码的通用实现
+constexpr FixedRuleSpec kFixedRules[kNumFixedRules] = {
+    {"B3/S23", 0x00C, 0x008},        // Conway 生命游戏
+    {"B36/S23", 0x00C, 0x048},       // HighLife
+    {"B2/S", 0x000, 0x004},          // Seeds
+    {"B3678/S34678", 0x1D8, 0x1C8},  // Day & Night
+    {"B3/S012345678", 0x1FF, 0x008}, // Life without Death
+};
+
+typedef void (*StepRowsFn)(const StepArgs &args, int y0, int y1, int w0, int w1);
+
+/**
+ * @struct StepRowsTable
+ * @brief 一种指令集下的全部规则实现
+ */
+struct StepRowsTable
+{
+    StepRowsFn generic;                ///< 运行时规则掩码的通用实现
+    StepRowsFn fixed[kNumFixedRules]; ///< 与 kFixedRules 一一对应的特化实现
+};
+
+const StepRowsTable &stepRowsScalar();
+
+#ifdef SMART_LIFE_X86
+const StepRowsTable &stepRowsSse2();
+const StepRowsTable &stepRowsAvx2();
+const StepRowsTable &stepRowsAvx512();
+#endif
+
+#endif // STEP_KERNEL_ISA_H
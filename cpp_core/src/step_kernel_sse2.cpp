@@ -0,0 +1,39 @@
+#include "step_kernel_isa.h"
+
+/**
+ * @file step_kernel_sse2.cpp
+ * @brief SSE2 演化核心，一次处理 128 个细胞
+ *
+ * 本文件以 SSE2 指令集选项编译，只能在 CPUID 确认支持后调用
+ */
+#ifdef SMART_LIFE_X86
+#include <emmintrin.h>
+#include "step_kernel_impl.h"
+
+namespace
+{
+    struct Sse2Ops
+    {
+        typedef __m128i vec;
+        static const int lanes = 2;
+        static vec load(const uint64_t *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+        static void store(uint64_t *p, vec v) { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v); }
+        static vec zero() { return _mm_setzero_si128(); }
+        static vec ones() { return _mm_set1_epi32(-1); }
+        static vec bitAnd(vec a, vec b) { return _mm_and_si128(a, b); }
+        static vec bitOr(vec a, vec b) { return _mm_or_si128(a, b); }
+        static vec bitXor(vec a, vec b) { return _mm_xor_si128(a, b); }
+        static vec andNot(vec a, vec b) { return _mm_andnot_si128(a, b); }
+        static vec shl1(vec a) { return _mm_slli_epi64(a, 1); }
+        static vec shr1(vec a) { return _mm_srli_epi64(a, 1); }
+        static vec shl63(vec a) { return _mm_slli_epi64(a, 63); }
+        static vec shr63(vec a) { return _mm_srli_epi64(a, 63); }
+    };
+}
+
+const StepRowsTable &stepRowsSse2()
+{
+    static const StepRowsTable table = makeStepRowsTable<Sse2Ops>();
+    return table;
+}
+#endif
@@ -0,0 +1,99 @@
+#include "../include/thread_pool.h"
+
+/**
+ * @file thread_pool.cpp
+ * @brief 常驻线程池实现
+ */
+ThreadPool::ThreadPool(int num_threads)
+    : task_(nullptr), count_(0), next_(0), active_(0), generation_(0), stop_(false)
+{
+    for (int i = 1; i < num_threads; i++)
+    {
+        workers_.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto &worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int)> &task)
+{
+    // 没有工作线程或只有一个子任务时直接在调用线程执行
+    if (workers_.empty() || count <= 1)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        count_ = count;
+        next_.store(0);
+        active_ = static_cast<int>(workers_.size());
+        generation_++;
+    }
+    start_cv_.notify_all();
+
+    // 调用线程同样领取子任务
+    runTasks();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this]()
+                  { return active_ == 0; });
+    task_ = nullptr;
+}
+
+void ThreadPool::workerLoop()
+{
+    unsigned long long seen = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_cv_.wait(lock, [this, seen]()
+                           { return stop_ || generation_ != seen; });
+            if (stop_)
+            {
+                return;
+            }
+            seen = generation_;
+        }
+
+        runTasks();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--active_ == 0)
+            {
+                done_cv_.notify_one();
+            }
+        }
+    }
+}
+
+void ThreadPool::runTasks()
+{
+    for (;;)
+    {
+        int i = next_.fetch_add(1);
+        if (i >= count_)
+        {
+            break;
+        }
+        (*task_)(i);
+    }
+}
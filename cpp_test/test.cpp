@@ -1,7 +1,474 @@
 #include <iostream>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
 #include "../cpp_core/include/cell.h"
 #include "../cpp_core/include/game_environment.h"
 #include "../cpp_core/include/config_parser.h"
+#include "../cpp_core/include/hashlife.h"
+#include "../cpp_core/include/rng.h"
+#include "../cpp_core/include/step_kernel.h"
+#include "../cpp_core/src/step_kernel_isa.h"
+
+// 构建（在 cpp_test 目录下，先构建 cpp_core 到 cpp_core/build）：
+//   g++ -std=c++14 -O2 test.cpp ../cpp_core/build/libsmart_life_core.a -lpthread -o test && ./test
+// 各项检查把不同实现的结果与逐格计算的参考实现比较，任一项失败时返回非 0
+
+namespace
+{
+  int failures = 0;
+
+  void check(bool ok, const std::string &what)
+  {
+    if (!ok)
+    {
+      failures++;
+      std::cout << "FAIL: " << what << std::endl;
+    }
+  }
+
+  // 逐格网格，下标为 y * width + x
+  typedef std::vector<uint8_t> Cells;
+
+  // 参考实现：逐格数邻居，wrap 为 false 时边界外视为无细胞，为 true 时按周期取模
+  Cells referenceStep(const Cells &cur, int width, int height, uint32_t survive_mask, uint32_t birth_mask, bool wrap)
+  {
+    Cells next(cur.size(), 0);
+    for (int y = 0; y < height; y++)
+    {
+      for (int x = 0; x < width; x++)
+      {
+        int count = 0;
+        for (int dy = -1; dy <= 1; dy++)
+        {
+          for (int dx = -1; dx <= 1; dx++)
+          {
+            if (dx == 0 && dy == 0)
+            {
+              continue;
+            }
+            int nx = x + dx, ny = y + dy;
+            if (wrap)
+            {
+              nx = ((nx % width) + width) % width;
+              ny = ((ny % height) + height) % height;
+            }
+            else if (nx < 0 || nx >= width || ny < 0 || ny >= height)
+            {
+              continue;
+            }
+            count += cur[ny * width + nx];
+          }
+        }
+        uint32_t mask = cur[y * width + x] ? survive_mask : birth_mask;
+        next[y * width + x] = (mask >> count) & 1u;
+      }
+    }
+    return next;
+  }
+
+  // 参考实现：按旧版 getCellStates() 的定义逐格取出每个细胞的视野
+  std::vector<float> referenceWindows(const GameEnvironment &env, const Cells &grid, bool wrap)
+  {
+    const int width = env.getWidth(), height = env.getHeight(), vision = env.getVision();
+    const CellStore &cells = env.getCells();
+    std::vector<float> out;
+    for (int i = 0; i < cells.size(); i++)
+    {
+      Position pos = cells.position(i);
+      for (int dy = -vision; dy <= vision; dy++)
+      {
+        for (int dx = -vision; dx <= vision; dx++)
+        {
+          int nx = pos.x + dx, ny = pos.y + dy;
+          if (wrap)
+          {
+            nx = ((nx % width) + width) % width;
+            ny = ((ny % height) + height) % height;
+          }
+          bool inside = nx >= 0 && nx < width && ny >= 0 && ny < height;
+          out.push_back(inside && grid[ny * width + nx] ? 1.0f : 0.0f);
+        }
+      }
+    }
+    return out;
+  }
+
+  Cells gridOf(const GameEnvironment &env)
+  {
+    Cells grid(static_cast<size_t>(env.getWidth()) * env.getHeight());
+    env.getGridState(grid.data());
+    return grid;
+  }
+
+  Cells gridOf(const BitGrid &grid)
+  {
+    Cells cells(static_cast<size_t>(grid.width()) * grid.height());
+    for (int y = 0; y < grid.height(); y++)
+    {
+      for (int x = 0; x < grid.width(); x++)
+      {
+        cells[y * grid.width() + x] = grid.get(x, y) ? 1 : 0;
+      }
+    }
+    return cells;
+  }
+
+  // 按行优先顺序排列的活细胞位置（细胞列表的顺序与演化路径有关，只比较集合）
+  std::vector<std::pair<int, int>> cellPositions(const GameEnvironment &env)
+  {
+    const CellStore &cells = env.getCells();
+    std::vector<std::pair<int, int>> positions;
+    for (int i = 0; i < cells.size(); i++)
+    {
+      positions.push_back(std::make_pair(cells.position(i).y, cells.position(i).x));
+    }
+    std::sort(positions.begin(), positions.end());
+    return positions;
+  }
+
+  bool sameCells(const GameEnvironment &a, const GameEnvironment &b)
+  {
+    const CellStore &x = a.getCells(), &y = b.getCells();
+    if (x.size() != y.size())
+    {
+      return false;
+    }
+    for (int i = 0; i < x.size(); i++)
+    {
+      if (x.id(i) != y.id(i) || x.position(i).x != y.position(i).x || x.position(i).y != y.position(i).y ||
+          x.alive(i) != y.alive(i) || x.age(i) != y.age(i) || x.energy(i) != y.energy(i))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::vector<std::string> temp_files;
+
+  // 写入测试用配置文件，未列出的键取默认值
+  std::string writeConfig(const std::string &name, const std::string &extra)
+  {
+    std::string path = "test_" + name + ".txt";
+    std::ofstream out(path.c_str());
+    out << "LIVE_MIN = 2\nLIVE_MAX = 3\nBREED_MIN = 3\nBREED_MAX = 3\n" << extra;
+    temp_files.push_back(path);
+    return path;
+  }
+
+  void fillRandom(BitGrid &grid, Rng &rng, double density)
+  {
+    grid.clear();
+    for (int y = 0; y < grid.height(); y++)
+    {
+      for (int x = 0; x < grid.width(); x++)
+      {
+        if (rng.nextDouble() < density)
+        {
+          grid.set(x, y);
+        }
+      }
+    }
+  }
+
+  const char *kRules[] = {"B3/S23", "B36/S23", "B2/S", "B3678/S34678", "B3/S012345678", "B34/S34", "B1357/S1357"};
+  const int kNumRules = sizeof(kRules) / sizeof(kRules[0]);
+
+  // advance(n) 与调用 n 次 update() 的结果一致；HashLife 引擎本身与参考实现一致
+  void testAdvance()
+  {
+    Rng rng(1);
+    for (int r = 0; r < kNumRules; r++)
+    {
+      uint32_t survive_mask, birth_mask;
+      parseRuleString(kRules[r], survive_mask, birth_mask);
+
+      // 节点上限很小，跳跃之间会触发垃圾回收
+      const int width = 100, height = 70;
+      BitGrid grid(width, height);
+      fillRandom(grid, rng, 0.3);
+      Cells ref = gridOf(grid);
+      HashLife hashlife(survive_mask, birth_mask, 5000);
+      const int steps[] = {1, 2, 3, 5, 8, 13, 64, 100};
+      for (int s = 0; s < 8; s++)
+      {
+        hashlife.advance(grid, steps[s]);
+        for (int g = 0; g < steps[s]; g++)
+        {
+          ref = referenceStep(ref, width, height, survive_mask, birth_mask, false);
+        }
+        check(gridOf(grid) == ref, std::string("HashLife ") + kRules[r] + " after " + std::to_string(steps[s]) + " more generations");
+      }
+
+      // 稀疏的局面在试探后走 HashLife，稠密或混沌的局面退回逐代演化，两者都须与 update() 一致
+      std::string config = writeConfig("advance", "DEATH_RATE = 0\nRESTORE_PROB = 0\nHASHLIFE_MAX_NODES = 20000\nRULE = " +
+                                                      std::string(kRules[r]) + "\n");
+      const int cell_counts[] = {40, 6000};
+      for (int c = 0; c < 2; c++)
+      {
+        GameEnvironment a(300, 200, config, 1, 7);
+        GameEnvironment b(300, 200, config, 1, 7);
+        a.initializeRandom(cell_counts[c]);
+        b.initializeRandom(cell_counts[c]);
+        check(a.isPureRule(), std::string("isPureRule ") + kRules[r]);
+        const int runs[] = {1, 63, 64, 300};
+        for (int n = 0; n < 4; n++)
+        {
+          a.advance(runs[n]);
+          for (int g = 0; g < runs[n]; g++)
+          {
+            b.update();
+          }
+          std::string what = std::string("advance(") + std::to_string(runs[n]) + ") " + kRules[r] + " with " +
+                             std::to_string(cell_counts[c]) + " cells";
+          check(gridOf(a) == gridOf(b), what + ": grid");
+          check(a.getPopulation() == b.getPopulation(), what + ": population");
+          check(cellPositions(a) == cellPositions(b), what + ": cell list");
+        }
+      }
+    }
+  }
+
+  // 各指令集的演化核心（通用与特化版本）与参考实现一致
+  void testKernels()
+  {
+    struct Isa
+    {
+      const char *name;
+      const StepRowsTable &(*table)();
+      bool supported;
+    };
+    std::vector<Isa> isas;
+    isas.push_back(Isa{"scalar", stepRowsScalar, true});
+#if defined(SMART_LIFE_X86) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    isas.push_back(Isa{"sse2", stepRowsSse2, __builtin_cpu_supports("sse2") != 0});
+    isas.push_back(Isa{"avx2", stepRowsAvx2, __builtin_cpu_supports("avx2") != 0});
+    isas.push_back(Isa{"avx512", stepRowsAvx512, __builtin_cpu_supports("avx512f") != 0});
+#endif
+    Rng rng(2);
+    const int widths[] = {1, 5, 63, 64, 65, 127, 128, 129, 200, 257, 520};
+    const int heights[] = {1, 2, 3, 17};
+    for (int wi = 0; wi < 11; wi++)
+    {
+      for (int hi = 0; hi < 4; hi++)
+      {
+        const int width = widths[wi], height = heights[hi];
+        BitGrid cur(width, height);
+        fillRandom(cur, rng, 0.35);
+        Cells cells = gridOf(cur);
+        for (int r = 0; r < kNumRules; r++)
+        {
+          uint32_t survive_mask, birth_mask;
+          parseRuleString(kRules[r], survive_mask, birth_mask);
+          Cells expected = referenceStep(cells, width, height, survive_mask, birth_mask, false);
+          for (size_t i = 0; i < isas.size(); i++)
+          {
+            if (!isas[i].supported)
+            {
+              continue;
+            }
+            const StepRowsTable &table = isas[i].table();
+            std::vector<StepRowsFn> fns(1, table.generic);
+            for (int f = 0; f < kNumFixedRules; f++)
+            {
+              if (kFixedRules[f].survive_mask == survive_mask && kFixedRules[f].birth_mask == birth_mask)
+              {
+                fns.push_back(table.fixed[f]);
+              }
+            }
+            for (size_t f = 0; f < fns.size(); f++)
+            {
+              BitGrid next(width, height);
+              StepArgs args;
+              args.cur = cur.row(0);
+              args.next = next.row(0);
+              args.stride = cur.stride();
+              args.words = cur.wordsPerRow();
+              args.padded = cur.paddedWordsPerRow();
+              args.tail = cur.lastWordMask();
+              args.survive_mask = survive_mask;
+              args.birth_mask = birth_mask;
+              fns[f](args, 0, height, 0, cur.wordsPerRow());
+              bool tail_clear = true;
+              for (int y = 0; y < height; y++)
+              {
+                tail_clear = tail_clear && (next.row(y)[next.wordsPerRow() - 1] & ~next.lastWordMask()) == 0;
+              }
+              std::string what = std::string(isas[i].name) + (f == 0 ? " generic " : " fixed ") + kRules[r] + " " +
+                                 std::to_string(width) + "x" + std::to_string(height);
+              check(gridOf(next) == expected, what);
+              check(tail_clear, what + ": bits beyond the width");
+            }
+          }
+        }
+      }
+    }
+
+    // 整个环境分别使用 SIMD 核心与查表引擎逐代演化
+    const char *kernels[] = {"simd", "lut"};
+    for (int k = 0; k < 2; k++)
+    {
+      for (int r = 0; r < kNumRules; r++)
+      {
+        uint32_t survive_mask, birth_mask;
+        parseRuleString(kRules[r], survive_mask, birth_mask);
+        std::string config = writeConfig("kernel", "DEATH_RATE = 0\nRESTORE_PROB = 0\nKERNEL = " + std::string(kernels[k]) +
+                                                       "\nRULE = " + kRules[r] + "\n");
+        GameEnvironment env(203, 131, config, 1, 3);
+        env.initializeRandom(8000);
+        check(std::string(env.getKernelName()) == "lut" || k == 0, "KERNEL = lut selects the lookup table");
+        Cells ref = gridOf(env);
+        for (int g = 0; g < 40; g++)
+        {
+          env.update();
+          ref = referenceStep(ref, 203, 131, survive_mask, birth_mask, false);
+        }
+        check(gridOf(env) == ref, std::string("KERNEL = ") + kernels[k] + " " + kRules[r]);
+      }
+    }
+  }
+
+  // 单线程与多线程的结果逐位一致，包括随机死亡、能量恢复与移动
+  void testThreads()
+  {
+    std::string config = writeConfig("threads", "VISION = 2\nDEATH_RATE = 0.05\nENERGY_CONSUMPTION = 0.1\n"
+                                                "RESTORE_PROB = 0.3\nRESTORE_VALUE = 0.2\n");
+    const int thread_counts[] = {2, 4, 7};
+    for (int t = 0; t < 3; t++)
+    {
+      GameEnvironment serial(333, 277, config, 1, 11);
+      GameEnvironment parallel(333, 277, config, thread_counts[t], 11);
+      serial.initializeRandom(30000);
+      parallel.initializeRandom(30000);
+      Rng rng(5);
+      bool same = gridOf(serial) == gridOf(parallel) && sameCells(serial, parallel);
+      for (int g = 0; g < 30 && same; g++)
+      {
+        if (g % 2 == 0)
+        {
+          serial.update();
+          parallel.update();
+        }
+        else
+        {
+          std::vector<int> moves(serial.getCells().size());
+          for (size_t i = 0; i < moves.size(); i++)
+          {
+            moves[i] = static_cast<int>(rng.nextInt(9));
+          }
+          serial.updateWithMoves(moves);
+          parallel.updateWithMoves(moves);
+        }
+        same = gridOf(serial) == gridOf(parallel) && sameCells(serial, parallel) &&
+               serial.getStepStats().births == parallel.getStepStats().births &&
+               serial.getStepStats().deaths == parallel.getStepStats().deaths;
+      }
+      check(same, "THREADS = 1 vs " + std::to_string(thread_counts[t]));
+    }
+  }
+
+  // 对每种观测格式与参考实现逐元素比较
+  void checkObservations(const GameEnvironment &env, const Cells &grid, bool wrap, const std::string &what)
+  {
+    const int count = env.getCells().size();
+    const int obs = env.getObservationSize();
+    const int packed_obs = env.getPackedObservationSize();
+    std::vector<float> expected = referenceWindows(env, grid, wrap);
+
+    std::vector<float> floats(static_cast<size_t>(count) * obs);
+    env.getCellStates(floats.data());
+    check(floats == expected, what + ": float observations");
+
+    std::vector<uint8_t> bytes(static_cast<size_t>(count) * obs);
+    env.getCellStates(bytes.data());
+    check(std::equal(bytes.begin(), bytes.end(), expected.begin(),
+                     [](uint8_t b, float f) { return static_cast<float>(b) == f; }),
+          what + ": uint8 observations");
+
+    std::vector<uint8_t> packed(static_cast<size_t>(count) * packed_obs);
+    env.getPackedCellStates(packed.data());
+    std::vector<float> unpacked(static_cast<size_t>(count) * obs);
+    GameEnvironment::unpackCellStates(packed.data(), count, obs, unpacked.data());
+    bool padding_clear = true;
+    for (int i = 0; i < count && obs % 8 != 0; i++)
+    {
+      padding_clear = padding_clear && (packed[static_cast<size_t>(i) * packed_obs + packed_obs - 1] >> (obs % 8)) == 0;
+    }
+    check(unpacked == expected, what + ": packed observations");
+    check(padding_clear, what + ": packed padding bits");
+  }
+
+  // float、uint8 与按位压缩的观测都与旧版 getCellStates() 的定义一致
+  void testObservations()
+  {
+    const int visions[] = {0, 1, 3, 6};
+    for (int v = 0; v < 4; v++)
+    {
+      std::string config = writeConfig("obs", "VISION = " + std::to_string(visions[v]) +
+                                                  "\nDEATH_RATE = 0.02\nENERGY_CONSUMPTION = 0.05\n");
+      GameEnvironment env(150, 90, config, 3, 13);
+      env.initializeRandom(3000);
+      Rng rng(6);
+      for (int g = 0; g < 6; g++)
+      {
+        std::vector<int> moves(env.getCells().size());
+        for (size_t i = 0; i < moves.size(); i++)
+        {
+          moves[i] = static_cast<int>(rng.nextInt(9));
+        }
+        env.updateWithMoves(moves);
+        std::string what = "VISION = " + std::to_string(visions[v]) + " generation " + std::to_string(g);
+        checkObservations(env, gridOf(env), false, what);
+
+        std::vector<std::vector<float>> legacy = env.getCellStates();
+        std::vector<float> flat;
+        for (size_t i = 0; i < legacy.size(); i++)
+        {
+          flat.insert(flat.end(), legacy[i].begin(), legacy[i].end());
+        }
+        check(flat == referenceWindows(env, gridOf(env), false), what + ": getCellStates()");
+      }
+    }
+  }
+
+  // 环绕边界与取模参考实现一致：宽度 1-130 覆盖单字、整字与跨字，两种演化引擎，单线程与多线程
+  void testWrap()
+  {
+    const char *kernels[] = {"simd", "lut"};
+    const int heights[] = {1, 2, 3, 9, 70};
+    const int thread_counts[] = {1, 3};
+    for (int k = 0; k < 2; k++)
+    {
+      std::string config = writeConfig("wrap_" + std::string(kernels[k]),
+                                       "VISION = 3\nDEATH_RATE = 0\nRESTORE_PROB = 0\nBOUNDARY = wrap\nKERNEL = " +
+                                           std::string(kernels[k]) + "\n");
+      for (int width = 1; width <= 130; width++)
+      {
+        const int height = heights[width % 5];
+        for (int t = 0; t < 2; t++)
+        {
+          GameEnvironment env(width, height, config, thread_counts[t], width);
+          env.initializeRandom(width * height * 2 / 5);
+          Cells ref = gridOf(env);
+          std::string what = std::string("wrap ") + kernels[k] + " " + std::to_string(width) + "x" + std::to_string(height) +
+                             " threads " + std::to_string(thread_counts[t]);
+          for (int g = 0; g < 8; g++)
+          {
+            env.update();
+            ref = referenceStep(ref, width, height, 0x00C, 0x008, true);
+            check(gridOf(env) == ref, what + " generation " + std::to_string(g));
+            checkObservations(env, ref, true, what + " generation " + std::to_string(g));
+          }
+        }
+      }
+    }
+  }
+}
+
 int main()
 {
   // 创建游戏环境
@@ -12,13 +479,13 @@ int main()
   env.initializeRandom(35);
   /*// 打印初始细胞状态
   const auto &cells = env.getCells();
-  for (const auto &cell : cells)
+  for (int i = 0; i < cells.size(); i++)
   {
-    std::cout << "Cell ID: " << cell->getId() << ", Position: ("
-              << cell->getPosition().x << ", " << cell->getPosition().y
-              << "), Alive: " << (cell->isAlive() ? "Yes" : "No")
-              << ", Age: " << cell->getAge()
-              << ", Energy: " << cell->getEnergy() << std::endl;
+    std::cout << "Cell ID: " << cells.id(i) << ", Position: ("
+              << cells.position(i).x << ", " << cells.position(i).y
+              << "), Alive: " << (cells.alive(i) ? "Yes" : "No")
+              << ", Age: " << cells.age(i)
+              << ", Energy: " << cells.energy(i) << std::endl;
   }*/
   // 打印二维数组
   auto grid = env.getGridState();
@@ -35,13 +502,14 @@ int main()
   env.update();
   /*// 打印更新后的细胞状态
   std::cout << "After update:" << std::endl;
-  for (const auto &cell : env.getCells())
+  for (int i = 0; i < env.getCells().size(); i++)
   {
-    std::cout << "Cell ID: " << cell->getId() << ", Position: ("
-              << cell->getPosition().x << ", " << cell->getPosition().y
-              << "), Alive: " << (cell->isAlive() ? "Yes" : "No")
-              << ", Age: " << cell->getAge()
-              << ", Energy: " << cell->getEnergy() << std::endl;
+    Cell cell = env.getCell(i);
+    std::cout << "Cell ID: " << cell.getId() << ", Position: ("
+              << cell.getPosition().x << ", " << cell.getPosition().y
+              << "), Alive: " << (cell.isAlive() ? "Yes" : "No")
+              << ", Age: " << cell.getAge()
+              << ", Energy: " << cell.getEnergy() << std::endl;
   }*/
   // 打印二维数组
   grid = env.getGridState();
@@ -55,5 +523,16 @@ int main()
     std::cout << std::endl;
   }
 
-  return 0;
+  // 等价性检查
+  testAdvance();
+  testKernels();
+  testThreads();
+  testObservations();
+  testWrap();
+  for (size_t i = 0; i < temp_files.size(); i++)
+  {
+    std::remove(temp_files[i].c_str());
+  }
+  std::cout << (failures == 0 ? "All checks passed" : std::to_string(failures) + " checks failed") << std::endl;
+  return failures == 0 ? 0 : 1;
 }
@@ -2,10 +2,17 @@
 #include <pybind11/stl.h>
 #include <pybind11/functional.h>
 #include <pybind11/numpy.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <vector>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include "../cpp_core/include/game_environment.h"
+#include "../cpp_core/include/batched_environment.h"
+#include "../cpp_core/include/sparse_grid.h"
+#include "../cpp_core/include/snapshot.h"
 #include "../cpp_core/include/types.h"
 
 namespace py = pybind11;
@@ -31,6 +38,16 @@ struct PyPosition
     }
 };
 
+// get_cells_array() 返回的结构化数组元素，字段与 get_cells() 的字典键一致
+struct PyCellRecord
+{
+    int32_t id;
+    int32_t x;
+    int32_t y;
+    int32_t age;
+    double energy;
+};
+
 // GameEnvironment 包装类
 class PyGameEnvironment
 {
@@ -38,8 +55,45 @@ private:
     std::unique_ptr<GameEnvironment> env_;
 
 public:
-    PyGameEnvironment(int width, int height, const std::string &config_file = "config.txt")
-        : env_(std::make_unique<GameEnvironment>(width, height, config_file)) {}
+    PyGameEnvironment(int width, int height, const std::string &config_file = "config.txt", int num_threads = 0,
+                      long long seed = -1)
+        : env_(std::make_unique<GameEnvironment>(width, height, config_file, num_threads, seed)) {}
+
+    void seed(unsigned long long seed)
+    {
+        env_->seed(seed);
+    }
+
+    unsigned long long get_seed()
+    {
+        return env_->getSeed();
+    }
+
+    void save_snapshot(const std::string &path)
+    {
+        bool ok;
+        {
+            py::gil_scoped_release release;
+            ok = env_->saveSnapshot(path);
+        }
+        if (!ok)
+        {
+            throw std::runtime_error("failed to write snapshot " + path);
+        }
+    }
+
+    void load_snapshot(const std::string &path)
+    {
+        bool ok;
+        {
+            py::gil_scoped_release release;
+            ok = env_->loadSnapshot(path);
+        }
+        if (!ok)
+        {
+            throw std::runtime_error("failed to load snapshot " + path + " (invalid file or size mismatch)");
+        }
+    }
 
     void initialize_random(int num_cells)
     {
@@ -61,6 +115,47 @@ public:
         env_->update();
     }
 
+    void advance(long long generations)
+    {
+        env_->advance(generations);
+    }
+
+    // 在 C++ 端连续演化，返回 (代数, 5) 的统计数组：population, density, new_density, births, deaths
+    py::array_t<double> run(int generations, bool stop_on_extinction, double saturation, bool new_density)
+    {
+        std::vector<StepRecord> records;
+        {
+            // 演化期间不访问 Python 对象，释放 GIL
+            py::gil_scoped_release release;
+            records = env_->run(generations, RunOptions(stop_on_extinction, saturation, new_density));
+        }
+
+        size_t rows = records.size();
+        auto result = py::array_t<double>({rows, static_cast<size_t>(5)});
+        auto buffer = result.mutable_unchecked<2>();
+
+        for (size_t i = 0; i < rows; i++)
+        {
+            buffer(i, 0) = records[i].population;
+            buffer(i, 1) = records[i].density;
+            buffer(i, 2) = records[i].new_density;
+            buffer(i, 3) = records[i].births;
+            buffer(i, 4) = records[i].deaths;
+        }
+
+        return result;
+    }
+
+    bool is_pure_rule()
+    {
+        return env_->isPureRule();
+    }
+
+    bool set_rule(const std::string &rule)
+    {
+        return env_->setRule(rule);
+    }
+
     void update_with_moves(py::list moves)
     {
         std::vector<int> moves_vec;
@@ -71,48 +166,106 @@ public:
         env_->updateWithMoves(moves_vec);
     }
 
+    // 细胞状态直接写入结果数组，不经过中间容器
     py::array_t<float> get_cell_states()
     {
-        auto states = env_->getCellStates();
+        size_t rows = static_cast<size_t>(env_->getCells().size());
+        size_t cols = static_cast<size_t>(observation_size());
 
-        if (states.empty())
+        if (rows == 0)
         {
             return py::array_t<float>({0, 0});
         }
 
-        // 创建 numpy 数组
-        size_t rows = states.size();
-        size_t cols = states[0].size();
-
         auto result = py::array_t<float>({rows, cols});
-        auto buffer = result.mutable_unchecked<2>();
+        float *data = result.mutable_data();
+        {
+            py::gil_scoped_release release;
+            env_->getCellStates(data);
+        }
 
-        for (size_t i = 0; i < rows; i++)
+        return result;
+    }
+
+    // 将细胞状态写入调用方预分配的 (容量, 观测长度) float32 数组，返回前 n 行（n 为细胞数量）的视图
+    py::object get_cell_states_into(py::array out)
+    {
+        size_t rows = static_cast<size_t>(env_->getCells().size());
+        size_t cols = static_cast<size_t>(observation_size());
+        // 不做类型转换：转换会产生副本，写入结果对调用方不可见
+        if (!py::isinstance<py::array_t<float>>(out) || !(out.flags() & py::array::c_style) || !out.writeable())
         {
-            for (size_t j = 0; j < cols; j++)
-            {
-                buffer(i, j) = states[i][j];
-            }
+            throw std::invalid_argument("out must be a writeable C-contiguous float32 array");
+        }
+        if (out.ndim() != 2 || static_cast<size_t>(out.shape(1)) != cols)
+        {
+            throw std::invalid_argument("out must have shape (capacity, (2 * VISION + 1) ** 2)");
+        }
+        if (static_cast<size_t>(out.shape(0)) < rows)
+        {
+            throw std::invalid_argument("out has fewer rows than there are cells");
+        }
+        float *data = static_cast<float *>(out.mutable_data());
+        {
+            py::gil_scoped_release release;
+            env_->getCellStates(data);
+        }
+
+        return out[py::slice(0, static_cast<py::ssize_t>(rows), 1)];
+    }
+
+    // 每个元素 1 字节的细胞状态，形状 (细胞数量, 观测长度)
+    py::array_t<uint8_t> get_cell_states_u8()
+    {
+        size_t rows = static_cast<size_t>(env_->getCells().size());
+        size_t cols = static_cast<size_t>(observation_size());
+
+        auto result = py::array_t<uint8_t>({rows, cols});
+        uint8_t *data = result.mutable_data();
+        {
+            py::gil_scoped_release release;
+            env_->getCellStates(data);
+        }
+
+        return result;
+    }
+
+    // 按位压缩的细胞状态，形状 (细胞数量, (观测长度 + 7) / 8)，位序同 numpy.unpackbits(bitorder="little")
+    py::array_t<uint8_t> get_cell_states_packed()
+    {
+        size_t rows = static_cast<size_t>(env_->getCells().size());
+        size_t cols = static_cast<size_t>(env_->getPackedObservationSize());
+
+        auto result = py::array_t<uint8_t>({rows, cols});
+        uint8_t *data = result.mutable_data();
+        {
+            py::gil_scoped_release release;
+            env_->getPackedCellStates(data);
         }
 
         return result;
     }
 
+    int observation_size()
+    {
+        return env_->getObservationSize();
+    }
+
     py::list get_cells()
     {
         const auto &cells = env_->getCells();
         py::list positions;
 
-        for (const auto &cell : cells)
+        for (int i = 0; i < cells.size(); i++)
         {
-            if (cell->isAlive())
+            if (cells.alive(i))
             {
                 py::dict cell_info;
-                cell_info["id"] = cell->getId();
-                cell_info["x"] = cell->getPosition().x;
-                cell_info["y"] = cell->getPosition().y;
-                cell_info["age"] = cell->getAge();
-                cell_info["energy"] = cell->getEnergy();
+                cell_info["id"] = cells.id(i);
+                cell_info["x"] = cells.position(i).x;
+                cell_info["y"] = cells.position(i).y;
+                cell_info["age"] = cells.age(i);
+                cell_info["energy"] = cells.energy(i);
                 positions.append(cell_info);
             }
         }
@@ -120,6 +273,34 @@ public:
         return positions;
     }
 
+    // 存活细胞的结构化数组 (id, x, y, age, energy)，直接从细胞存储的各列填充
+    py::array_t<PyCellRecord> get_cells_array()
+    {
+        const auto &cells = env_->getCells();
+        const uint8_t *alive = cells.aliveData();
+        const int count = cells.size();
+
+        size_t rows = static_cast<size_t>(std::count_if(alive, alive + count, [](uint8_t a)
+                                                        { return a != 0; }));
+        auto result = py::array_t<PyCellRecord>(static_cast<py::ssize_t>(rows));
+        PyCellRecord *out = result.mutable_data();
+
+        const int *ids = cells.idData();
+        const int *xs = cells.xData();
+        const int *ys = cells.yData();
+        const int *ages = cells.ageData();
+        const double *energies = cells.energyData();
+        for (int i = 0; i < count; i++)
+        {
+            if (alive[i])
+            {
+                *out++ = PyCellRecord{ids[i], xs[i], ys[i], ages[i], energies[i]};
+            }
+        }
+
+        return result;
+    }
+
     int get_population()
     {
         return env_->getPopulation();
@@ -130,6 +311,17 @@ public:
         return env_->getDensity();
     }
 
+    // 最近一次演化的出生、死亡与移动数
+    py::dict get_step_stats()
+    {
+        const StepStats &stats = env_->getStepStats();
+        py::dict result;
+        result["births"] = stats.births;
+        result["deaths"] = stats.deaths;
+        result["moves"] = stats.moves;
+        return result;
+    }
+
     int get_width()
     {
         return env_->getWidth();
@@ -150,27 +342,56 @@ public:
         env_->printConfig();
     }
 
-    // 获取网格状态（用于可视化）
+    // 获取网格状态（用于可视化）：直接展开位压缩网格，只写一遍结果数组
     py::array_t<bool> get_grid_state()
     {
-        auto grid = env_->getGridState();
+        size_t rows = static_cast<size_t>(env_->getHeight());
+        size_t cols = static_cast<size_t>(env_->getWidth());
 
-        if (grid.empty())
+        auto result = py::array_t<bool>({rows, cols});
+        uint8_t *data = reinterpret_cast<uint8_t *>(result.mutable_data());
         {
-            return py::array_t<bool>({0, 0});
+            py::gil_scoped_release release;
+            env_->getGridState(data);
         }
 
-        size_t rows = grid.size();
-        size_t cols = grid[0].size();
+        return result;
+    }
 
-        auto result = py::array_t<bool>({rows, cols});
-        auto buffer = result.mutable_unchecked<2>();
+    // 将网格状态写入调用方提供的 (height, width) 数组（bool/uint8/int8，C 连续），每帧复用时不再分配
+    py::array get_grid_state_into(py::array out)
+    {
+        if (out.ndim() != 2 || out.shape(0) != env_->getHeight() || out.shape(1) != env_->getWidth())
+        {
+            throw std::invalid_argument("out must have shape (height, width)");
+        }
+        if (out.itemsize() != 1 || !(out.flags() & py::array::c_style) || !out.writeable())
+        {
+            throw std::invalid_argument("out must be a writeable C-contiguous array with 1-byte elements");
+        }
+        uint8_t *data = static_cast<uint8_t *>(out.mutable_data());
+        {
+            py::gil_scoped_release release;
+            env_->getGridState(data);
+        }
+        return out;
+    }
 
-        for (size_t i = 0; i < rows; i++)
+    // 位压缩网格的副本，形状 (height, 每行字数)：每行一次 memcpy，共 W*H/8 字节。
+    // 不返回指向 grid_ 的视图：update() 交换 grid_ 与 next_grid_ 的存储，视图会静默地指向另一代
+    py::array_t<uint64_t> get_grid_words()
+    {
+        const BitGrid &grid = env_->getGrid();
+        size_t rows = static_cast<size_t>(grid.height());
+        size_t cols = static_cast<size_t>(grid.wordsPerRow());
+
+        auto result = py::array_t<uint64_t>({rows, cols});
+        uint64_t *data = result.mutable_data();
         {
-            for (size_t j = 0; j < cols; j++)
+            py::gil_scoped_release release;
+            for (size_t y = 0; y < rows; y++)
             {
-                buffer(i, j) = grid[i][j];
+                std::memcpy(data + y * cols, grid.row(static_cast<int>(y)), cols * sizeof(uint64_t));
             }
         }
 
@@ -208,12 +429,320 @@ public:
     {
         return env_->newDensity();
     }
+
+    // 连通分量统计，返回 (分量数, 5) 的数组：cells, min_x, min_y, max_x, max_y
+    py::array_t<int32_t> get_components()
+    {
+        const std::vector<ComponentInfo> &components = env_->getComponents();
+        size_t rows = components.size();
+        auto result = py::array_t<int32_t>({rows, static_cast<size_t>(5)});
+        auto buffer = result.mutable_unchecked<2>();
+
+        for (size_t i = 0; i < rows; i++)
+        {
+            buffer(i, 0) = components[i].cells;
+            buffer(i, 1) = components[i].min_x;
+            buffer(i, 2) = components[i].min_y;
+            buffer(i, 3) = components[i].max_x;
+            buffer(i, 4) = components[i].max_y;
+        }
+
+        return result;
+    }
+
+    // 获取正在使用的演化核心名称
+    std::string get_kernel_name()
+    {
+        return env_->getKernelName();
+    }
+
+    // 获取边界模式（dead/wrap）
+    std::string get_boundary()
+    {
+        return env_->getBoundary();
+    }
+
+    // 获取演化核心特化的规则
+    std::string get_kernel_rule()
+    {
+        return env_->getKernelRule();
+    }
+
+    // 获取演化使用的线程数
+    int get_num_threads()
+    {
+        return env_->getNumThreads();
+    }
+};
+
+// BatchedGameEnvironment 包装类
+class PyBatchedGameEnvironment
+{
+private:
+    std::unique_ptr<BatchedGameEnvironment> batch_;
+
+    py::array_t<int> offsets_array(const std::vector<int> &offsets)
+    {
+        auto result = py::array_t<int>(static_cast<py::ssize_t>(offsets.size()));
+        std::copy(offsets.begin(), offsets.end(), result.mutable_data());
+        return result;
+    }
+
+public:
+    PyBatchedGameEnvironment(int num_envs, int width, int height, const std::string &config_file = "config.txt",
+                             int num_threads = 0, long long seed = -1)
+        : batch_(std::make_unique<BatchedGameEnvironment>(num_envs, width, height, config_file, num_threads, seed)) {}
+
+    void seed(unsigned long long seed)
+    {
+        batch_->seed(seed);
+    }
+
+    int size()
+    {
+        return batch_->size();
+    }
+
+    void initialize_random(int num_cells)
+    {
+        py::gil_scoped_release release;
+        batch_->initializeRandom(num_cells);
+    }
+
+    void update()
+    {
+        py::gil_scoped_release release;
+        batch_->update();
+    }
+
+    // moves 为所有环境拼接后的一维移动指令，按 cell_offsets() 拆分
+    void update_with_moves(py::array_t<int, py::array::c_style | py::array::forcecast> moves)
+    {
+        const int *data = moves.data();
+        int count = static_cast<int>(moves.size());
+        py::gil_scoped_release release;
+        batch_->updateWithMoves(data, count);
+    }
+
+    py::array_t<int> cell_offsets()
+    {
+        return offsets_array(batch_->cellOffsets());
+    }
+
+    // 返回 (states, offsets)：states 形状为 (细胞总数, 观测长度)，第 i 个环境的细胞为 states[offsets[i]:offsets[i+1]]
+    // 各环境的细胞状态直接写入结果数组，不经过中间容器
+    py::tuple get_cell_states()
+    {
+        size_t rows = static_cast<size_t>(batch_->cellOffsets().back());
+        size_t cols = static_cast<size_t>(batch_->observationSize());
+        auto result = py::array_t<float>({rows, cols});
+        float *data = result.mutable_data();
+        const std::vector<int> *offsets;
+        {
+            py::gil_scoped_release release;
+            offsets = &batch_->getCellStates(data);
+        }
+
+        return py::make_tuple(result, offsets_array(*offsets));
+    }
+
+    // 将拼接后的细胞状态写入调用方预分配的 (容量, 观测长度) float32 数组，返回 (前 n 行的视图, offsets)
+    py::tuple get_cell_states_into(py::array out)
+    {
+        size_t rows = static_cast<size_t>(batch_->cellOffsets().back());
+        size_t cols = static_cast<size_t>(batch_->observationSize());
+        // 不做类型转换：转换会产生副本，写入结果对调用方不可见
+        if (!py::isinstance<py::array_t<float>>(out) || !(out.flags() & py::array::c_style) || !out.writeable())
+        {
+            throw std::invalid_argument("out must be a writeable C-contiguous float32 array");
+        }
+        if (out.ndim() != 2 || static_cast<size_t>(out.shape(1)) != cols)
+        {
+            throw std::invalid_argument("out must have shape (capacity, (2 * VISION + 1) ** 2)");
+        }
+        if (static_cast<size_t>(out.shape(0)) < rows)
+        {
+            throw std::invalid_argument("out has fewer rows than there are cells in all environments");
+        }
+        float *data = static_cast<float *>(out.mutable_data());
+        const std::vector<int> *offsets;
+        {
+            py::gil_scoped_release release;
+            offsets = &batch_->getCellStates(data);
+        }
+
+        return py::make_tuple(out[py::slice(0, static_cast<py::ssize_t>(rows), 1)], offsets_array(*offsets));
+    }
+
+    std::vector<int> get_populations()
+    {
+        return batch_->getPopulations();
+    }
+
+    int get_num_threads()
+    {
+        return batch_->getNumThreads();
+    }
+};
+
+// SparseGrid 包装类
+class PySparseGrid
+{
+private:
+    std::unique_ptr<SparseGrid> grid_;
+
+public:
+    explicit PySparseGrid(const std::string &rule = "B3/S23")
+    {
+        uint32_t survive_mask, birth_mask;
+        if (!parseRuleString(rule, survive_mask, birth_mask))
+        {
+            throw std::invalid_argument("invalid rule string: " + rule);
+        }
+        if (!SparseGrid::supportsRule(birth_mask))
+        {
+            throw std::invalid_argument("rules with B0 cannot run on an unbounded plane");
+        }
+        grid_ = std::make_unique<SparseGrid>(survive_mask, birth_mask);
+    }
+
+    void set_cell(int x, int y)
+    {
+        grid_->set(x, y);
+    }
+
+    void remove_cell(int x, int y)
+    {
+        grid_->reset(x, y);
+    }
+
+    bool get_cell(int x, int y)
+    {
+        return grid_->get(x, y);
+    }
+
+    void clear()
+    {
+        grid_->clear();
+    }
+
+    void step(int generations)
+    {
+        py::gil_scoped_release release;
+        grid_->step(generations);
+    }
+
+    long long get_generation()
+    {
+        return grid_->getGeneration();
+    }
+
+    long long get_population()
+    {
+        return grid_->count();
+    }
+
+    int get_chunk_count()
+    {
+        return grid_->chunkCount();
+    }
+
+    // 返回 (min_x, min_y, max_x, max_y)，平面为空时返回 None
+    py::object get_bounding_box()
+    {
+        int min_x, min_y, max_x, max_y;
+        if (!grid_->boundingBox(min_x, min_y, max_x, max_y))
+        {
+            return py::none();
+        }
+        return py::make_tuple(min_x, min_y, max_x, max_y);
+    }
+
+    // 返回 (细胞数, 2) 的 int32 数组，每行为 (x, y)，按行优先顺序排列
+    py::array_t<int32_t> get_cells()
+    {
+        std::vector<Position> cells;
+        grid_->getCells(cells);
+        size_t rows = cells.size();
+        auto result = py::array_t<int32_t>({rows, static_cast<size_t>(2)});
+        auto buffer = result.mutable_unchecked<2>();
+
+        for (size_t i = 0; i < rows; i++)
+        {
+            buffer(i, 0) = cells[i].x;
+            buffer(i, 1) = cells[i].y;
+        }
+
+        return result;
+    }
+
+    // 返回以 (x, y) 为左上角的 (height, width) 区域
+    py::array_t<bool> get_grid_state(int x, int y, int width, int height)
+    {
+        if (width < 0 || height < 0)
+        {
+            throw std::invalid_argument("width and height must be non-negative");
+        }
+        auto result = py::array_t<bool>({static_cast<size_t>(height), static_cast<size_t>(width)});
+        uint8_t *data = reinterpret_cast<uint8_t *>(result.mutable_data());
+        {
+            py::gil_scoped_release release;
+            grid_->getRegion(x, y, width, height, data);
+        }
+        return result;
+    }
 };
 
 PYBIND11_MODULE(smart_life_core, m)
 {
     m.doc() = "Smart Game of Life - PyBind11 Bindings";
 
+    PYBIND11_NUMPY_DTYPE(PyCellRecord, id, x, y, age, energy);
+
+    m.def("kernel_name", []()
+          { return std::string(selectStepKernel().name); },
+          "Get the name of the stepping kernel selected from CPUID (scalar/sse2/avx2/avx512)");
+
+    m.def("unpack_cell_states", [](py::array_t<uint8_t, py::array::c_style | py::array::forcecast> packed, int obs_size)
+          {
+              if (packed.ndim() != 2 || packed.shape(1) != (obs_size + 7) / 8)
+              {
+                  throw std::invalid_argument("packed must have shape (n, (obs_size + 7) // 8)");
+              }
+              size_t rows = static_cast<size_t>(packed.shape(0));
+              auto result = py::array_t<float>({rows, static_cast<size_t>(obs_size)});
+              const uint8_t *src = packed.data();
+              float *dst = result.mutable_data();
+              {
+                  py::gil_scoped_release release;
+                  GameEnvironment::unpackCellStates(src, static_cast<int>(rows), obs_size, dst);
+              }
+              return result; },
+          py::arg("packed"), py::arg("obs_size"),
+          "Expand bit-packed cell states (e.g. a replay batch) into a (n, obs_size) float32 array");
+
+    m.def("snapshot_info", [](const std::string &path)
+          {
+              SnapshotHeader header;
+              std::string error;
+              if (!readSnapshotHeader(path, header, error))
+              {
+                  throw std::runtime_error(path + ": " + error);
+              }
+              header.rule[sizeof(header.rule) - 1] = '\0';
+              py::dict info;
+              info["version"] = header.version;
+              info["width"] = header.width;
+              info["height"] = header.height;
+              info["rule"] = std::string(header.rule);
+              info["boundary"] = header.wrap ? "wrap" : "dead";
+              info["cells"] = header.cell_count;
+              info["seed"] = header.seed;
+              info["generation"] = header.generation;
+              return info; },
+          py::arg("path"),
+          "Read a snapshot header without loading it: version, width, height, rule, boundary, cells, seed, generation");
+
     // 绑定 Position 类
     py::class_<PyPosition>(m, "Position")
         .def(py::init<>())
@@ -232,24 +761,74 @@ PYBIND11_MODULE(smart_life_core, m)
         .def(py::init<int, int, std::string>(),
              py::arg("width"), py::arg("height"), py::arg("config_file"),
              "Create a new game environment with config file")
+        .def(py::init<int, int, std::string, int>(),
+             py::arg("width"), py::arg("height"), py::arg("config_file"), py::arg("num_threads"),
+             "Create a new game environment with config file and worker thread count (0 = THREADS from config)")
+        .def(py::init<int, int, std::string, int, long long>(),
+             py::arg("width"), py::arg("height"), py::arg("config_file"), py::arg("num_threads"), py::arg("seed"),
+             "Create a new game environment with a fixed random seed (negative = seed from std::random_device)")
+        .def("seed", &PyGameEnvironment::seed,
+             py::arg("seed"),
+             "Reseed the environment; later initialize_random/update calls are fully reproducible")
+        .def("get_seed", &PyGameEnvironment::get_seed,
+             "Get the random seed in use")
+        .def("save_snapshot", &PyGameEnvironment::save_snapshot,
+             py::arg("path"),
+             "Save the full state (grid, cells, rule, boundary, RNG) to a versioned binary snapshot")
+        .def("load_snapshot", &PyGameEnvironment::load_snapshot,
+             py::arg("path"),
+             "Restore the full state from a snapshot of the same size; stepping continues exactly as in the saved environment")
         .def("initialize_random", &PyGameEnvironment::initialize_random,
              py::arg("num_cells"),
              "Initialize the environment with random cells")
         .def("update", &PyGameEnvironment::update,
              "Update the game state (standard Conway rules)")
+        .def("advance", &PyGameEnvironment::advance,
+             py::arg("generations"),
+             "Advance several generations without moves (HashLife for long runs under a pure rule unless the board is chaotic)")
+        .def("run", &PyGameEnvironment::run,
+             py::arg("generations"), py::arg("stop_on_extinction") = true, py::arg("saturation") = 0.8,
+             py::arg("new_density") = false,
+             "Run up to n generations in C++, stopping early on extinction or when population reaches "
+             "saturation * area; returns an (steps, 5) array of population, density, new_density, births, deaths per generation")
+        .def("is_pure_rule", &PyGameEnvironment::is_pure_rule,
+             "Check whether evolution is fully determined by the rule (no death rate, restore or exhausted cells)")
+        .def("set_rule", &PyGameEnvironment::set_rule,
+             py::arg("rule"),
+             "Switch to a B/S rule string such as \"B36/S23\"; returns False and keeps the old rule if it is malformed")
         .def("update_with_moves", &PyGameEnvironment::update_with_moves,
              py::arg("moves"),
              "Update the game state with cell moves")
         .def("get_cell_states", &PyGameEnvironment::get_cell_states,
              "Get the current state of all cells as a numpy array")
+        .def("get_cell_states_into", &PyGameEnvironment::get_cell_states_into,
+             py::arg("out"),
+             "Write cell states into a preallocated (capacity, obs) float32 array and return the filled rows")
+        .def("get_cell_states_u8", &PyGameEnvironment::get_cell_states_u8,
+             "Get cell states as a (cells, obs) uint8 array of 0/1")
+        .def("get_cell_states_packed", &PyGameEnvironment::get_cell_states_packed,
+             "Get bit-packed cell states as a (cells, (obs + 7) // 8) uint8 array (little bit order); "
+             "expand with unpack_cell_states")
+        .def("observation_size", &PyGameEnvironment::observation_size,
+             "Get the length of one cell state vector, (2 * VISION + 1) ** 2")
         .def("get_cells", &PyGameEnvironment::get_cells,
              "Get positions and info of all living cells")
+        .def("get_cells_array", &PyGameEnvironment::get_cells_array,
+             "Get all living cells as one structured numpy array with fields id, x, y, age, energy")
         .def("get_grid_state", &PyGameEnvironment::get_grid_state,
              "Get the entire grid state as a numpy array")
+        .def("get_grid_state_into", &PyGameEnvironment::get_grid_state_into,
+             py::arg("out"),
+             "Fill a preallocated (height, width) 1-byte array with the grid state and return it")
+        .def("get_grid_words", &PyGameEnvironment::get_grid_words,
+             "Copy the bit-packed grid into a (height, words) uint64 array; cell x is bit x % 64 of word x // 64, "
+             "e.g. np.unpackbits(w.view(np.uint8), axis=1, bitorder='little')[:, :width]")
         .def("get_population", &PyGameEnvironment::get_population,
              "Get the current population count")
         .def("get_density", &PyGameEnvironment::get_density,
              "Get the current population density")
+        .def("get_step_stats", &PyGameEnvironment::get_step_stats,
+             "Get births, deaths and moves of the last update as a dict")
         .def("get_width", &PyGameEnvironment::get_width,
              "Get the grid width")
         .def("get_height", &PyGameEnvironment::get_height,
@@ -273,5 +852,80 @@ PYBIND11_MODULE(smart_life_core, m)
         .def("set_cell", &PyGameEnvironment::set_cell,
              py::arg("x"), py::arg("y"),
              "Set a cell at the specified position")
-        .def("new_density", &PyGameEnvironment::new_density, "Return a more accurate cell density");
+        .def("new_density", &PyGameEnvironment::new_density, "Return a more accurate cell density")
+        .def("get_components", &PyGameEnvironment::get_components,
+             "Get the 8-connected cell clusters as an (n, 5) int32 array of cells, min_x, min_y, max_x, max_y")
+        .def("get_kernel_name", &PyGameEnvironment::get_kernel_name,
+             "Get the name of the stepping kernel used by this environment")
+        .def("get_boundary", &PyGameEnvironment::get_boundary,
+             "Get the boundary mode: \"dead\" (cells beyond the edge are empty) or \"wrap\" (toroidal)")
+        .def("get_kernel_rule", &PyGameEnvironment::get_kernel_rule,
+             "Get the rule the stepping kernel is specialized for (\"generic\" when none matches)")
+        .def("get_num_threads", &PyGameEnvironment::get_num_threads,
+             "Get the number of threads used by update()");
+
+    // 绑定 BatchedGameEnvironment 类
+    py::class_<PyBatchedGameEnvironment>(m, "BatchedGameEnvironment")
+        .def(py::init<int, int, int, std::string, int, long long>(),
+             py::arg("num_envs"), py::arg("width"), py::arg("height"), py::arg("config_file") = "config.txt",
+             py::arg("num_threads") = 0, py::arg("seed") = -1,
+             "Create N independent environments stepped in parallel (0 threads = hardware concurrency); "
+             "environment i uses seed + i, a negative seed seeds each from std::random_device")
+        .def("seed", &PyBatchedGameEnvironment::seed,
+             py::arg("seed"),
+             "Reseed all environments, environment i with seed + i")
+        .def("__len__", &PyBatchedGameEnvironment::size)
+        .def("initialize_random", &PyBatchedGameEnvironment::initialize_random,
+             py::arg("num_cells"),
+             "Initialize every environment with random cells")
+        .def("update", &PyBatchedGameEnvironment::update,
+             "Advance every environment by one generation")
+        .def("update_with_moves", &PyBatchedGameEnvironment::update_with_moves,
+             py::arg("moves"),
+             "Update every environment with a flat moves array split by cell_offsets(); missing moves stay in place")
+        .def("cell_offsets", &PyBatchedGameEnvironment::cell_offsets,
+             "Get N+1 offsets of each environment's cells in the concatenated arrays")
+        .def("get_cell_states", &PyBatchedGameEnvironment::get_cell_states,
+             "Get (states, offsets): concatenated cell observations and per-environment offsets")
+        .def("get_cell_states_into", &PyBatchedGameEnvironment::get_cell_states_into,
+             py::arg("out"),
+             "Write concatenated cell observations into a preallocated (capacity, obs) float32 array; "
+             "returns (view of the first n rows, offsets)")
+        .def("get_populations", &PyBatchedGameEnvironment::get_populations,
+             "Get the population of every environment")
+        .def("get_num_threads", &PyBatchedGameEnvironment::get_num_threads,
+             "Get the number of threads stepping the environments");
+
+    // 绑定 SparseGrid 类
+    py::class_<PySparseGrid>(m, "SparseGrid")
+        .def(py::init<std::string>(),
+             py::arg("rule") = "B3/S23",
+             "Create an empty unbounded plane stored as 64x64 chunks allocated on demand (rules with B0 are rejected)")
+        .def("set_cell", &PySparseGrid::set_cell,
+             py::arg("x"), py::arg("y"),
+             "Place a cell; coordinates may be negative")
+        .def("remove_cell", &PySparseGrid::remove_cell,
+             py::arg("x"), py::arg("y"),
+             "Remove a cell, freeing its chunk once the chunk is empty")
+        .def("get_cell", &PySparseGrid::get_cell,
+             py::arg("x"), py::arg("y"),
+             "Check whether a cell is alive")
+        .def("clear", &PySparseGrid::clear,
+             "Remove every cell and reset the generation counter")
+        .def("step", &PySparseGrid::step,
+             py::arg("generations") = 1,
+             "Advance the plane by the given number of generations")
+        .def("get_generation", &PySparseGrid::get_generation,
+             "Get the number of generations stepped so far")
+        .def("get_population", &PySparseGrid::get_population,
+             "Get the number of live cells")
+        .def("get_chunk_count", &PySparseGrid::get_chunk_count,
+             "Get the number of allocated (non-empty) chunks")
+        .def("get_bounding_box", &PySparseGrid::get_bounding_box,
+             "Get (min_x, min_y, max_x, max_y) of the live cells, or None when the plane is empty")
+        .def("get_cells", &PySparseGrid::get_cells,
+             "Get an (n, 2) int32 array of live cell (x, y) coordinates in row-major order")
+        .def("get_grid_state", &PySparseGrid::get_grid_state,
+             py::arg("x"), py::arg("y"), py::arg("width"), py::arg("height"),
+             "Get the (height, width) region whose top-left corner is (x, y)");
 }